@@ -2,8 +2,16 @@
 #define ALLOCATOR_H
 
 #include <list>
+#include <string>
+#include <map>
+#include <vector>
+#include <unordered_map>
 #include <cstddef>
 #include "common.h"
+#include "free_index.h"
+#include "tag_heap.h"
+#include "tlsf_index.h"
+#include "free_stats.h"
 
 /*
  * Supported dynamic memory allocation strategies.
@@ -11,33 +19,376 @@
 enum AllocatorType {
     FIRST_FIT,   // Allocate first sufficiently large free block
     BEST_FIT,    // Allocate smallest free block that fits
-    WORST_FIT    // Allocate largest available free block
+    WORST_FIT,   // Allocate largest available free block
+    NEXT_FIT,    // First Fit resuming where the last allocation ended
+    TLSF         // Two-Level Segregated Fit: O(1) good-fit bins
 };
 
 /*
- * Global allocator state
- *
- * These variables represent the simulated physical memory
- * and are shared across all allocation strategies.
+ * Number of AllocatorType values.
  */
+const int ALLOCATOR_TYPES = TLSF + 1;
 
 /*
- * Linked list representing the physical memory layout.
- * Each node corresponds to a contiguous memory block.
+ * Per-strategy request accounting, used to compare strategies
+ * on the same workload.
  */
-extern std::list<Block> memory_blocks;
+struct StrategyStats {
+    int requests;       // Allocation requests routed to the strategy
+    int success;        // Successful allocations
+    double total_ns;    // Total time spent in placement (nanoseconds)
+};
 
 /*
- * Total size of simulated physical memory (bytes).
+ * Representations of the simulated physical memory.
+ * Selected when memory is initialized.
  */
-extern size_t TOTAL_MEMORY;
+enum HeapBackend {
+    LIST_HEAP,   // Node-per-block std::list with free-block index
+    TAGGED_HEAP  // Contiguous boundary-tag arena (TagHeap)
+};
 
 /*
- * Allocation statistics.
+ * Outcome of a heap compaction.
  */
-extern int alloc_requests;   // Total allocation requests issued
-extern int alloc_success;    // Successful allocations
-extern int next_block_id;    // Unique identifier for allocated blocks
+struct CompactionResult {
+    std::map<size_t, size_t> relocation;   // Old start address → new start address
+    size_t bytes_moved = 0;                // Total size of the relocated blocks
+};
+
+/*
+ * Outcome of a realloc.
+ */
+struct ReallocResult {
+    bool ok = false;           // False if the block could not be resized
+    bool moved = false;        // True if the data had to be relocated
+    size_t bytes_copied = 0;   // Bytes copied by a move
+    Block block;               // The resized (or new) block
+};
+
+/*
+ * Arena
+ *
+ * A region carved from a heap as one allocated block. Objects are
+ * bump-allocated inside it without per-object headers and are all
+ * released together by resetting the bump pointer.
+ */
+struct Arena {
+    int block_id;            // Heap block backing the arena (-1 once destroyed)
+    size_t base;             // Start address of the region (after the block header)
+    size_t header = 0;       // Block header bytes in front of base
+    size_t capacity;         // Region size in bytes
+    size_t offset = 0;       // Bump pointer, relative to base
+
+    /*
+     * Statistics counters
+     */
+    int objects = 0;             // Objects allocated since the last reset
+    int total_objects = 0;       // Objects allocated over the arena's life
+    int failures = 0;            // Allocations that did not fit
+    int resets = 0;              // Bulk frees
+    size_t peak = 0;             // Highest bump offset reached
+    size_t requested = 0;        // Bytes requested since the last reset
+};
+
+/*
+ * Heap
+ *
+ * One simulated physical memory and its allocator state: the block
+ * list (or boundary-tag arena), the free-block indexes, the lookup
+ * tables and the statistics counters.
+ *
+ * Heaps share no state, so several can be simulated side by side,
+ * and independent heaps can be driven from different threads.
+ * A heap is not copyable: its indexes refer into its own block list.
+ */
+class Heap {
+public:
+    /*
+     * Configuration parameters
+     */
+    size_t total_memory = 0;          // Total size of simulated memory (bytes)
+    HeapBackend backend = LIST_HEAP;  // Active memory representation
+
+    /*
+     * Block layout, applied to new allocations
+     */
+    size_t header_size = 0;   // Per-block header bytes
+    size_t footer_size = 0;   // Per-block footer bytes
+    size_t granularity = 1;   // Block sizes are rounded up to a multiple of this
+    size_t min_split = 0;     // Smaller remainders are not split off
+
+    /*
+     * Linked list representing the physical memory layout.
+     * Each node corresponds to a contiguous memory block.
+     */
+    std::list<Block> memory_blocks;
+
+    /*
+     * Boundary-tag arena used when backend is TAGGED_HEAP.
+     */
+    TagHeap tag_heap;
+
+    /*
+     * Constant-time block lookup, kept in sync on split, allocate,
+     * free and coalesce.
+     *  - block_by_id:      block ID → allocated block
+     *  - block_by_address: start address → block (free or allocated)
+     */
+    std::unordered_map<int, std::list<Block>::iterator> block_by_id;
+    std::unordered_map<size_t, std::list<Block>::iterator> block_by_address;
+
+    /*
+     * Statistics counters
+     */
+    int alloc_requests = 0;   // Total allocation requests issued
+    int alloc_success = 0;    // Successful allocations
+    int next_block_id = 1;    // Unique identifier for allocated blocks
+    size_t used_bytes = 0;        // Bytes in allocated blocks
+    size_t requested_bytes = 0;   // Bytes requested by allocated blocks
+    StrategyStats strategy_stats[ALLOCATOR_TYPES] = {};
+    StrategyStats aligned_stats = {};   // Aligned allocations (malloc_aligned)
+
+    /*
+     * Compact-on-failure settings and counters
+     */
+    bool auto_compact = false;      // Compact and retry when placement fails
+    size_t compact_budget = 0;      // Max bytes one automatic compaction may move (0 = no limit)
+    int compactions = 0;            // Compactions performed
+    int compactions_skipped = 0;    // Automatic compactions refused by the budget
+    int compaction_rescues = 0;     // Failed requests served after compacting
+    size_t compacted_bytes = 0;     // Bytes moved by all compactions
+
+    /*
+     * Realloc counters
+     */
+    int reallocs = 0;               // Successful reallocs
+    int reallocs_in_place = 0;      // Reallocs that did not move the block
+    size_t realloc_copied = 0;      // Bytes copied by moving reallocs
+
+    /*
+     * Arenas carved from this heap, indexed by arena ID.
+     */
+    std::vector<Arena> arenas;
+
+    Heap() {}
+    Heap(const Heap &) = delete;
+    Heap &operator=(const Heap &) = delete;
+
+    /*
+     * Reset the heap to a single free block of `size` bytes,
+     * stored in the given backend representation.
+     */
+    void init(size_t size, HeapBackend kind = LIST_HEAP);
+
+    /*
+     * Size of the block that serves a `requested`-byte request:
+     * header + payload + footer, rounded up to the granularity.
+     */
+    size_t block_size_for(size_t requested) const;
+
+    /*
+     * Silent placement for each strategy on the active backend.
+     * Return false if no free block fits; otherwise fill `out`
+     * with the allocated block. Request counters are not touched.
+     */
+    bool place_first_fit(size_t size, Block &out);
+    bool place_best_fit(size_t size, Block &out);
+    bool place_worst_fit(size_t size, Block &out);
+    bool place_next_fit(size_t size, Block &out);
+    bool place_tlsf(size_t size, Block &out);
+
+    /*
+     * Silent placement with the strategy `type`.
+     */
+    bool place(AllocatorType type, size_t size, Block &out);
+
+    /*
+     * Route a request to the placement of `type`, updating the
+     * request and per-strategy counters and placement timing.
+     */
+    bool place_block(AllocatorType type, size_t size, Block &out);
+
+    /*
+     * Placement followed by a printed report of the result.
+     */
+    void malloc_first_fit(size_t size);
+    void malloc_best_fit(size_t size);
+    void malloc_worst_fit(size_t size);
+    void malloc_next_fit(size_t size);
+    void malloc_tlsf(size_t size);
+
+    /*
+     * Allocate `size` bytes whose payload (the address after the
+     * block header) is a multiple of `align` (a power of two),
+     * choosing the lowest such placement (First Fit). Any gap before the aligned start stays free; a
+     * gap smaller than min_split is avoided by moving to the next
+     * aligned address. List backend only. Returns false if nothing fits.
+     *
+     * place_aligned_block adds the request counting, timing and
+     * compact-on-failure of place_block.
+     */
+    bool place_aligned(size_t size, size_t align, Block &out);
+    bool place_aligned_block(size_t size, size_t align, Block &out);
+    void malloc_aligned(size_t size, size_t align);
+
+    /*
+     * Resize allocated block `id` to `new_size` bytes.
+     * Shrinks split off the tail in place; grows extend into a free
+     * successor in place when it is large enough. Otherwise a new
+     * block is placed with strategy `type`, the data is copied and
+     * the old block freed; the new block has a new ID. On failure
+     * the old block is left untouched. List backend only.
+     */
+    ReallocResult realloc(int id, size_t new_size,
+                          AllocatorType type = FIRST_FIT);
+
+    /*
+     * Arena operations.
+     *  arena_create:  carve a `capacity`-byte region with strategy
+     *                 `type`; returns the arena ID or -1
+     *  arena_alloc:   bump-allocate `size` bytes; returns the address
+     *                 or (size_t)-1 if the arena is full
+     *  arena_reset:   free every object in the arena in O(1)
+     *  arena_destroy: return the region to the heap
+     */
+    int arena_create(size_t capacity, AllocatorType type = FIRST_FIT);
+    size_t arena_alloc(int arena, size_t size);
+    bool arena_reset(int arena);
+    bool arena_destroy(int arena);
+
+    /*
+     * Print per-arena usage and bulk-free statistics.
+     */
+    void arena_stats();
+
+    /*
+     * Free a previously allocated block using its block ID.
+     * Automatically coalesces adjacent free blocks.
+     */
+    void free_block(int id);
+
+    /*
+     * Free a block by its starting physical address.
+     */
+    void free_by_address(size_t address);
+
+    /*
+     * Silent counterparts of free_block() and free_by_address().
+     * Return the freed block's ID, or -1 if no such block is allocated.
+     */
+    int release_id(int id);
+    int release_address(size_t address);
+
+    /*
+     * Slide every allocated block toward address 0, preserving order
+     * and block IDs, and merge all free space into one block at the
+     * top of memory. Returns the relocation map of the moved blocks.
+     */
+    CompactionResult compact();
+
+    /*
+     * Free-block totals and histogram of the active backend,
+     * maintained incrementally (no heap scan).
+     */
+    const FreeSpaceStats &free_stats() const;
+
+    /*
+     * Size of the largest free block, read from the free-block
+     * index of the active backend (0 if memory is full).
+     */
+    size_t largest_free() const;
+
+    /*
+     * Print a visualization of the current memory layout.
+     */
+    void dump();
+
+    /*
+     * Print allocator statistics including:
+     *  - Fragmentation metrics
+     *  - Memory utilization
+     *  - Allocation success rate
+     *  - Per-strategy success and placement cost
+     * All figures come from running counters, so this is O(1).
+     */
+    void stats();
+
+    /*
+     * Print the log2-bucketed histogram of free block sizes.
+     */
+    void frag_histogram();
+
+    /*
+     * Verify the heap structure in one pass over every block:
+     *  - Blocks tile [0, total_memory) with no gaps or overlaps
+     *  - No two adjacent blocks are both free (coalescing)
+     *  - Running counters, free-space totals, lookup maps and the
+     *    active free index agree with the blocks
+     *  - The Next Fit rover sits on a block boundary
+     * Returns false and describes the first violation in `error`.
+     */
+    bool check_invariants(std::string &error) const;
+
+private:
+    /*
+     * Search indexes over the free blocks in memory_blocks.
+     * Only the family used by the current strategy is kept in sync
+     * (see activate_free_index).
+     *  - free_index: treaps for First, Best and Worst Fit
+     *  - tlsf_index: segregated bins for TLSF
+     */
+    enum IndexFamily { TREE_INDEX, TLSF_BINS };
+    IndexFamily index_family = TREE_INDEX;
+    FreeIndex free_index;
+    TlsfIndex tlsf_index;
+
+    /*
+     * Free-block totals for the list backend, updated wherever a
+     * free block enters or leaves the free indexes.
+     */
+    FreeSpaceStats free_space;
+
+    /*
+     * Next Fit rover: the block boundary where the last Next Fit
+     * allocation ended. Moved back to the start of a free block
+     * that absorbs it when coalescing.
+     */
+    size_t rover = 0;
+
+    /*
+     * Arena backed by each arena region, keyed by the region's
+     * block ID (recorded when the region is carved).
+     */
+    std::unordered_map<int, int> arena_by_block;
+
+    void index_free(std::list<Block>::iterator it);
+    void unindex_free(std::list<Block>::iterator it);
+    void activate_free_index(AllocatorType type);
+    std::list<Block>::iterator carve_block(std::list<Block>::iterator it,
+                                           size_t size, size_t requested);
+    bool carve_tagged(size_t start, size_t size, size_t requested,
+                      Block &out);
+    int release_tagged(size_t start);
+    int arena_backed_by(int id) const;
+    int allocated_id_at(size_t address) const;
+    void settle_rover(size_t start, size_t size);
+    int release_block(std::list<Block>::iterator it);
+
+    template <typename Place>
+    bool place_counted(StrategyStats &stats, size_t size, Block &out,
+                       Place place);
+    void compaction_plan(size_t &cost, size_t &free_bytes);
+
+    template <typename Visit>
+    void for_each_block(Visit visit);
+};
+
+/*
+ * Heap operated on by the allocator API below
+ * (selected with the CLI's heap commands).
+ */
+extern Heap *current_heap;
 
 /*
  * Total memory accesses (used for global summary reporting).
@@ -48,13 +399,20 @@ extern int total_memory_accesses;
  * Allocator API
  *
  * These functions provide a unified interface for memory
- * allocation, deallocation, visualization, and statistics.
+ * allocation, deallocation, visualization, and statistics
+ * on the current heap.
  */
 
 /*
- * Initialize the physical memory with a single free block.
+ * Initialize the physical memory with a single free block,
+ * stored in the given backend representation.
  */
-void init_memory(size_t size);
+void init_memory(size_t size, HeapBackend backend = LIST_HEAP);
+
+/*
+ * CLI name of a strategy ("first_fit", ..., "tlsf").
+ */
+const char *allocator_name(AllocatorType type);
 
 /*
  * Allocate memory using the First Fit strategy.
@@ -71,6 +429,30 @@ void malloc_best_fit(size_t size);
  */
 void malloc_worst_fit(size_t size);
 
+/*
+ * Allocate memory using the Next Fit strategy.
+ */
+void malloc_next_fit(size_t size);
+
+/*
+ * Allocate memory using Two-Level Segregated Fit (list backend).
+ */
+void malloc_tlsf(size_t size);
+
+/*
+ * Allocate `size` bytes aligned to `align` (a power of two),
+ * in the style of posix_memalign.
+ */
+void malloc_aligned(size_t size, size_t align);
+
+/*
+ * Resize block `id` to `new_size` bytes, in place when possible,
+ * otherwise by moving it with strategy `type`. Reports whether the
+ * block moved and how many bytes were copied. (Named realloc_block
+ * to stay clear of the C library's realloc.)
+ */
+void realloc_block(int id, size_t new_size, AllocatorType type = FIRST_FIT);
+
 /*
  * Free a previously allocated block using its block ID.
  * Automatically coalesces adjacent free blocks.
@@ -82,17 +464,30 @@ void free_block(int id);
  */
 void free_by_address(size_t address);
 
+/*
+ * Compact the current heap (see Heap::compact).
+ */
+CompactionResult compact_memory();
+
 /*
  * Print a visualization of the current memory layout.
  */
 void dump_memory();
 
 /*
- * Print allocator statistics including:
- *  - Fragmentation metrics
- *  - Memory utilization
- *  - Allocation success rate
+ * Print allocator statistics for the current heap.
  */
 void stats();
 
+/*
+ * Time `requests` rounds of allocating `objects` small objects and
+ * releasing them, with per-object frees versus one arena reset.
+ */
+void run_arena_benchmark(int requests, int objects);
+
+/*
+ * Print the free-size histogram of the current heap.
+ */
+void frag_histogram();
+
 #endif
@@ -1,8 +1,9 @@
 #ifndef BUDDY_H
 #define BUDDY_H
 
-#include <map>
 #include <vector>
+#include <string>
+#include <cstdint>
 #include <cstddef>
 
 /*
@@ -16,23 +17,46 @@
  *  - Total memory size must be a power of two
  *  - Allocation sizes are rounded up to the nearest power of two
  *  - Each block has a unique "buddy" determined using XOR
+ *
+ * Free blocks are tracked with one bitmap per order (bit set when a
+ * free block of that order starts at the corresponding position) and
+ * intrusive doubly linked free lists whose links are stored per
+ * minimum-size slot. Checking whether a buddy is free and unlinking
+ * it are therefore both O(1).
  */
 class BuddyAllocator {
 public:
+    /*
+     * Sentinel address terminating the intrusive free lists.
+     */
+    static const size_t NONE = (size_t)-1;
+
     /*
      * Configuration parameters
      */
     size_t total_size;   // Total managed memory size (power of two)
     size_t min_block;    // Smallest allocatable block size
+    bool verbose = true; // Print a message per allocate / free
 
     /*
-     * Free lists indexed by block size.
+     * Maximum number of orders (block sizes min_block << k).
+     */
+    static const int MAX_ORDERS = 64;
+
+    /*
+     * Free lists indexed by order.
      *
-     * Each key represents a block size (2^k),
-     * and the corresponding value is a list of starting addresses
-     * of currently free blocks of that size.
+     * free_lists[k] is the starting address of the first free block
+     * of size min_block << k (NONE if empty). The remaining blocks
+     * are reached through the intrusive links in next_free.
+     */
+    size_t free_lists[MAX_ORDERS];
+
+    /*
+     * Bit k is set while free_lists[k] is non-empty, so the smallest
+     * usable order is found with one count-trailing-zeros.
      */
-    std::map<size_t, std::vector<size_t>> free_lists;
+    uint64_t nonempty_orders;
 
     /*
      * Constructor
@@ -61,11 +85,19 @@ public:
     /*
      * Free a previously allocated block.
      *
+     * The block's order is read from the allocation map, so only the
+     * address is needed. Addresses that are not the start of a live
+     * allocation (invalid or double frees) are rejected in O(1).
+     * When `size` is given it must match the recorded block size.
+     *
      * The allocator attempts to recursively merge the block
      * with its buddy (if free) to form larger blocks,
      * restoring larger free blocks where possible.
+     *
+     * Returns true if the block was freed.
      */
-    void free_block(size_t addr, size_t size);
+    bool free_block(size_t addr);
+    bool free_block(size_t addr, size_t size);
 
     /*
      * Print the current state of all buddy free lists.
@@ -73,6 +105,78 @@ public:
      * Useful for debugging and demonstration purposes.
      */
     void dump();
+
+    /*
+     * Print allocation statistics including:
+     *  - Allocated and requested bytes
+     *  - Internal fragmentation (rounding waste)
+     *  - External fragmentation of the free space
+     *  - Rejected frees
+     */
+    void stats();
+
+    /*
+     * Size of the largest free block: the highest non-empty order
+     * (0 if memory is full).
+     */
+    size_t largest_free() const
+    {
+        return nonempty_orders == 0 ? 0
+            : min_block << (63 - __builtin_clzll(nonempty_orders));
+    }
+
+    /*
+     * Verify the allocator structure in one pass over memory:
+     *  - Allocated and free blocks tile the memory, each aligned
+     *    to its size, with no overlaps
+     *  - No free block has a free buddy of the same order
+     *  - Free lists, bitmaps and the non-empty mask agree
+     *  - Byte and block counters match the allocated blocks
+     * Returns false and describes the first violation in `error`.
+     */
+    bool check_invariants(std::string &error) const;
+
+    /*
+     * Statistics counters
+     */
+    size_t allocated_bytes = 0;   // Bytes in allocated (rounded) blocks
+    size_t requested_bytes = 0;   // Bytes requested by live allocations
+    int live_blocks = 0;          // Currently allocated blocks
+    int alloc_requests = 0;       // Allocation requests issued
+    int alloc_failures = 0;       // Requests that could not be served
+    int rejected_frees = 0;       // Invalid or double frees
+
+private:
+    /*
+     * Intrusive free-list links, one entry per min_block slot.
+     * Only the slot at the start of a free block is meaningful.
+     */
+    std::vector<size_t> next_free;
+    std::vector<size_t> prev_free;
+
+    /*
+     * free_bits[k] has one bit per block position of order k
+     * (block size min_block << k); a set bit marks a free block.
+     */
+    std::vector<std::vector<uint64_t>> free_bits;
+
+    /*
+     * Allocation map, one entry per min_block slot: the order of the
+     * allocated block starting there, or NOT_ALLOCATED.
+     * requested_at holds the size originally requested for it.
+     */
+    static const uint8_t NOT_ALLOCATED = 0xFF;
+    std::vector<uint8_t> alloc_order;
+    std::vector<size_t> requested_at;
+
+    int min_shift;   // log2(min_block)
+    int max_order;   // Order of the whole memory
+
+    int order_for(size_t size) const;
+    bool is_free(size_t addr, int order) const;
+    void set_free_bit(size_t addr, int order, bool value);
+    void push_free(size_t addr, int order);
+    void remove_free(size_t addr, int order);
 };
 
 #endif
@@ -2,6 +2,7 @@
 #define COMMON_H
 
 #include <cstddef>
+#include <list>
 
 /*
  * Block
@@ -16,6 +17,13 @@ struct Block {
     size_t requested;    // Size originally requested by the user (for internal fragmentation)
     bool free;           // Indicates whether the block is free or allocated
     int id;              // Unique identifier for allocated blocks (-1 for free blocks)
+
+    /*
+     * Intrusive links of the TLSF bin holding this free block
+     * (see TlsfIndex); an end of the bin links to itself.
+     */
+    std::list<Block>::iterator bin_prev;
+    std::list<Block>::iterator bin_next;
 };
 
 #endif
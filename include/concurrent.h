@@ -0,0 +1,132 @@
+#ifndef CONCURRENT_H
+#define CONCURRENT_H
+
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "buddy.h"
+#include "allocator.h"
+
+/*
+ * Size-class configuration of the thread caches.
+ *
+ * Requests up to MAX_SMALL_SIZE bytes are rounded to one of
+ * SIZE_CLASSES classes (16-byte steps up to 128, then four classes
+ * per power of two). Larger requests go straight to the central heap.
+ */
+const int SIZE_CLASSES = 24;
+const size_t MAX_SMALL_SIZE = 2048;
+
+/*
+ * Objects moved between a thread cache and the central heap per
+ * refill or flush. A cache list is flushed once it holds more than
+ * 2 * TRANSFER_BATCH objects.
+ */
+const int TRANSFER_BATCH = 32;
+
+/*
+ * Central heaps a ConcurrentAllocator can draw from.
+ */
+enum CentralBackend {
+    CENTRAL_BUDDY,   // Private BuddyAllocator
+    CENTRAL_LIST     // Private list Heap (First Fit placement)
+};
+
+/*
+ * ThreadCache
+ *
+ * Per-thread free lists, one per size class. A cache is only ever
+ * touched by its owning thread, so hits need no synchronization.
+ */
+struct ThreadCache {
+    std::vector<size_t> lists[SIZE_CLASSES];   // Cached object addresses
+
+    /*
+     * Statistics counters
+     */
+    long hits = 0;       // Allocations served from the cache
+    long misses = 0;     // Allocations that triggered a refill
+    long failures = 0;   // Allocations the central heap could not serve
+};
+
+/*
+ * ConcurrentAllocator
+ *
+ * Multi-threaded allocator front-end modeled on tcmalloc/jemalloc.
+ * Small requests are served from per-thread caches of size classes,
+ * which refill from and flush to a mutex-protected central heap in
+ * batches, so the central lock is taken once per TRANSFER_BATCH
+ * objects instead of once per operation.
+ *
+ * With caching disabled every request locks the central heap,
+ * which gives the contention baseline.
+ *
+ * The central lock records acquisitions, contended acquisitions
+ * (try_lock failed) and the time spent waiting for it.
+ */
+class ConcurrentAllocator {
+public:
+    /*
+     * Sentinel returned on allocation failure.
+     */
+    static const size_t NONE = (size_t)-1;
+
+    /*
+     * Constructor
+     *
+     * Builds the allocator over a central heap of `heap_size` bytes.
+     */
+    ConcurrentAllocator(CentralBackend backend, size_t heap_size,
+                        bool use_cache);
+
+    /*
+     * Allocate `size` bytes for the thread owning `cache`.
+     * Returns the address or NONE.
+     */
+    size_t allocate(ThreadCache &cache, size_t size);
+
+    /*
+     * Free an object of `size` bytes (sized free, as with sdallocx).
+     */
+    void deallocate(ThreadCache &cache, size_t addr, size_t size);
+
+    /*
+     * Return every object cached by `cache` to the central heap.
+     */
+    void flush(ThreadCache &cache);
+
+    /*
+     * Central lock statistics
+     */
+    long lock_acquisitions = 0;   // Times the central lock was taken
+    long contended = 0;           // Acquisitions that had to wait
+    double wait_ns = 0;           // Total time spent waiting
+
+private:
+    CentralBackend backend;
+    bool use_cache;
+    BuddyAllocator buddy;         // Central heap for CENTRAL_BUDDY
+    Heap heap;                    // Central heap for CENTRAL_LIST
+    std::mutex central;           // Protects the central heap
+
+    size_t class_size[SIZE_CLASSES];                   // Object size per class
+    uint8_t class_of[MAX_SMALL_SIZE / 16 + 1];         // (size + 15) / 16 → class
+
+    void lock();
+    size_t central_alloc(size_t size);
+    void central_free(size_t addr);
+    void refill(ThreadCache &cache, int cls);
+    void release_batch(std::vector<size_t> &list, size_t count);
+};
+
+/*
+ * Drive a ConcurrentAllocator from 1, 2, 4, ... up to `max_threads`
+ * std::threads, each performing `ops_per_thread` mixed malloc/free
+ * operations, with and without thread caches. Reports ops/sec,
+ * central lock contention and cache hit rate per thread count.
+ */
+void run_concurrent_benchmark(CentralBackend backend, int max_threads,
+                              int ops_per_thread);
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef FREE_INDEX_H
+#define FREE_INDEX_H
+
+#include <list>
+#include <vector>
+#include <cstddef>
+#include "common.h"
+
+/*
+ * FreeIndex
+ *
+ * Search index over the free blocks of the physical memory list.
+ * It lets the placement strategies find a block in O(log n)
+ * instead of scanning every block in memory.
+ *
+ * Two treaps are maintained over the same set of free blocks:
+ *  - Address-ordered, augmented with the largest block size in
+ *    each subtree (First Fit)
+ *  - Size-ordered, ties broken by address (Best Fit, Worst Fit)
+ *
+ * Every query returns exactly the block the original linear scan
+ * would have selected. Tree nodes live in a contiguous pool and
+ * are recycled, so steady-state updates do not touch the host heap.
+ *
+ * A block must be erased before its start or size is modified,
+ * and re-inserted afterwards if it is still free.
+ */
+class FreeIndex {
+public:
+    typedef std::list<Block>::iterator BlockRef;
+
+    FreeIndex();
+
+    /*
+     * Remove all indexed blocks.
+     */
+    void clear();
+
+    /*
+     * Add / remove a free block.
+     */
+    void insert(BlockRef block);
+    void erase(BlockRef block);
+
+    /*
+     * Placement queries. Each returns false when no free block
+     * of at least `size` bytes exists.
+     *
+     *  first_fit: lowest-addressed block that fits
+     *  first_fit_from: lowest-addressed block at or above `address`
+     *             that fits (Next Fit)
+     *  best_fit:  smallest block that fits (lowest address on ties)
+     *  worst_fit: largest block (lowest address on ties)
+     */
+    bool first_fit(size_t size, BlockRef &out) const;
+    bool first_fit_from(size_t address, size_t size, BlockRef &out) const;
+    bool best_fit(size_t size, BlockRef &out) const;
+    bool worst_fit(size_t size, BlockRef &out) const;
+
+    /*
+     * Size of the largest indexed block (0 if none), read from the
+     * root of the address tree.
+     */
+    size_t largest() const
+    {
+        return by_address == -1 ? 0 : nodes[by_address].max_size;
+    }
+
+    /*
+     * Number of indexed free blocks.
+     */
+    size_t count() const { return indexed; }
+
+private:
+    /*
+     * Treap node. Address-tree nodes are keyed by (start, 0),
+     * size-tree nodes by (size, start).
+     */
+    struct Node {
+        size_t key1, key2;   // Ordering key
+        size_t size;         // Size of the indexed block
+        size_t max_size;     // Largest block size in this subtree
+        unsigned priority;   // Heap priority for balancing
+        int left, right;     // Child node indices (-1 if none)
+        BlockRef block;      // Indexed block
+    };
+
+    std::vector<Node> nodes;     // Node pool
+    std::vector<int> spare;      // Recycled node indices
+    int by_address;              // Root of the address-ordered tree
+    int by_size;                 // Root of the size-ordered tree
+    size_t indexed;              // Number of indexed blocks
+    unsigned seed;               // Priority generator state
+
+    int new_node(size_t key1, size_t key2, BlockRef block);
+    void update(int t);
+    bool less(int t, size_t key1, size_t key2) const;
+    void split(int t, size_t key1, size_t key2, int &l, int &r);
+    int merge(int l, int r);
+    int insert_node(int root, int n);
+    int erase_node(int root, size_t key1, size_t key2);
+    int lower_bound(int root, size_t key1, size_t key2) const;
+    int first_fit_from(int t, size_t address, size_t size) const;
+};
+
+#endif
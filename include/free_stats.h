@@ -0,0 +1,58 @@
+#ifndef FREE_STATS_H
+#define FREE_STATS_H
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * FreeSpaceStats
+ *
+ * Running summary of the free blocks of a heap, updated whenever a
+ * free block is created or removed (split, allocate, free, coalesce)
+ * so fragmentation metrics can be read without scanning the heap.
+ *
+ * Free blocks are counted in a log2-bucketed histogram: bucket k
+ * holds blocks of size [2^k, 2^(k+1)). The exact largest free block
+ * is not tracked here; the heap reads it from its free-block index.
+ */
+class FreeSpaceStats {
+public:
+    /*
+     * Number of histogram buckets (one per power of two).
+     */
+    static const int BUCKETS = 64;
+
+    /*
+     * Running totals
+     */
+    size_t free_bytes = 0;           // Bytes in free blocks
+    size_t free_blocks = 0;          // Number of free blocks
+    size_t blocks[BUCKETS] = {};     // Free blocks per log2 bucket
+    size_t bytes[BUCKETS] = {};      // Free bytes per log2 bucket
+
+    /*
+     * Forget every free block.
+     */
+    void clear();
+
+    /*
+     * Record a free block of `size` bytes appearing / disappearing.
+     */
+    void add(size_t size);
+    void remove(size_t size);
+
+    /*
+     * Bit k is set while bucket k is non-empty.
+     */
+    uint64_t nonempty_buckets() const { return nonempty; }
+
+    /*
+     * Histogram bucket of a block size (size must be non-zero).
+     */
+    static int bucket(size_t size);
+
+private:
+    uint64_t nonempty = 0;               // Non-empty bucket mask
+};
+
+#endif
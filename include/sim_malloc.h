@@ -0,0 +1,104 @@
+#ifndef SIM_MALLOC_H
+#define SIM_MALLOC_H
+
+#include <cstddef>
+#include <cstdint>
+#include "allocator.h"
+#include "buddy.h"
+
+/*
+ * RealHeap
+ *
+ * Runs a simulator allocator over real memory. A region is mapped
+ * from the operating system (mmap, or VirtualAlloc on Windows) and
+ * one of the strategies manages it: First, Best, Worst or Next Fit
+ * or TLSF on a list Heap, or a BuddyAllocator. Every simulated
+ * address is an offset into the region, so allocations return
+ * usable pointers, aligned to ALIGNMENT like malloc's.
+ *
+ * Allocator metadata (block list, indexes) stays in host memory,
+ * outside the region, as in the simulator.
+ */
+class RealHeap {
+public:
+    /*
+     * Alignment of every returned pointer (as for malloc).
+     */
+    static const size_t ALIGNMENT = alignof(std::max_align_t);
+
+    RealHeap() {}
+    ~RealHeap() { shutdown(); }
+    RealHeap(const RealHeap &) = delete;
+    RealHeap &operator=(const RealHeap &) = delete;
+
+    /*
+     * Map `size` bytes managed by strategy `type`. Block sizes are
+     * rounded to ALIGNMENT so every block, and so every payload,
+     * starts aligned. Returns false if the region cannot be mapped.
+     */
+    bool init(AllocatorType type, size_t size);
+
+    /*
+     * Map `size` bytes managed by a buddy allocator with
+     * `min_block`-byte minimum blocks (min_block is raised to
+     * ALIGNMENT if smaller). Returns false without touching the
+     * current region unless both are powers of two and
+     * size >= min_block, or if the region cannot be mapped.
+     */
+    bool init_buddy(size_t size, size_t min_block);
+
+    /*
+     * Allocate `size` bytes; nullptr on failure.
+     */
+    void *allocate(size_t size);
+
+    /*
+     * Free a pointer returned by allocate(). Pointers outside the
+     * region and invalid frees are ignored.
+     */
+    void release(void *ptr);
+
+    /*
+     * Unmap the region and drop the allocator state.
+     */
+    void shutdown();
+
+    /*
+     * Start of the mapped region (nullptr when not initialized).
+     */
+    char *region() const { return base; }
+
+    int failures = 0;   // Allocations that could not be served
+
+private:
+    char *base = nullptr;       // Mapped region
+    size_t length = 0;          // Region size in bytes
+    bool use_buddy = false;     // Buddy allocator instead of the heap
+    AllocatorType strategy = FIRST_FIT;
+    Heap heap;                  // List heap for the fit strategies / TLSF
+    BuddyAllocator buddy{16, 16};
+
+    bool map_region(size_t size);
+};
+
+/*
+ * C-style API over one process-wide RealHeap.
+ *
+ *  sim_init / sim_init_buddy: map and select the allocator
+ *  sim_malloc / sim_free:     allocate and free real memory
+ *  sim_shutdown:              unmap the region
+ */
+bool sim_init(AllocatorType type, size_t size);
+bool sim_init_buddy(size_t size, size_t min_block);
+void *sim_malloc(size_t size);
+void sim_free(void *ptr);
+void sim_shutdown();
+
+/*
+ * Run the same malloc/free workload, writing every allocated byte
+ * and periodically reading all live objects, through glibc malloc
+ * and through each simulator allocator on real memory.
+ */
+void run_real_benchmark(int ops);
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include "buddy.h"
+
+/*
+ * Slab
+ *
+ * A buddy block carved into equally sized objects of one cache.
+ * Free objects are tracked with a bitmap (bit set = object free).
+ */
+struct Slab {
+    size_t base;                    // Start address of the buddy block
+    int cache;                      // Owning cache index
+    int in_use;                     // Allocated objects in this slab
+    std::vector<uint64_t> free_map; // One bit per object, set when free
+    std::vector<size_t> requested;  // Requested size of each live object
+    int state;                      // SLAB_FULL, SLAB_PARTIAL or SLAB_EMPTY
+    std::list<int>::iterator where; // Position in the cache's state list
+};
+
+/*
+ * Slab states, used to index SlabCache::lists.
+ */
+enum SlabState {
+    SLAB_FULL,      // Every object allocated
+    SLAB_PARTIAL,   // Some objects allocated
+    SLAB_EMPTY      // No objects allocated
+};
+
+/*
+ * SlabCache
+ *
+ * Object cache for one object size, in the style of the kernel's
+ * kmem_cache. Slabs move between the full, partial and empty lists
+ * as objects are allocated and freed.
+ */
+struct SlabCache {
+    size_t object_size;             // Size of each object in bytes
+    size_t slab_size;               // Size of each slab (buddy block)
+    int objects_per_slab;           // Objects carved from one slab
+    std::list<int> lists[3];        // Slab indices per SlabState
+
+    /*
+     * Statistics counters
+     */
+    int objects_in_use = 0;         // Live objects
+    size_t requested_bytes = 0;     // Bytes requested by live objects
+    size_t buddy_equivalent = 0;    // Bytes raw buddy would use for them
+};
+
+/*
+ * SlabAllocator
+ *
+ * Object caching layer on top of a BuddyAllocator. Each cache carves
+ * buddy blocks into fixed-size objects, so small fixed-size requests
+ * avoid being rounded up to a power of two individually.
+ *
+ * Because buddy blocks are aligned to their size, the slab owning an
+ * object is found by masking its address with the slab size.
+ * At most one empty slab per cache is kept; further empty slabs are
+ * returned to the buddy allocator.
+ */
+class SlabAllocator {
+public:
+    /*
+     * Minimum number of objects carved from each slab.
+     */
+    static const int MIN_OBJECTS = 8;
+
+    /*
+     * Constructor
+     *
+     * Layers the slab allocator on the given buddy allocator.
+     */
+    explicit SlabAllocator(BuddyAllocator *pages);
+
+    /*
+     * Drop all caches and slabs (used when the buddy memory
+     * is reinitialized; no pages are returned).
+     */
+    void reset();
+
+    /*
+     * Create a cache for objects of `object_size` bytes.
+     * Returns the cache index, or -1 if the size cannot be served.
+     */
+    int create_cache(size_t object_size);
+
+    /*
+     * Allocate an object of at least `size` bytes from the smallest
+     * cache that fits. Returns its address or (size_t)-1.
+     */
+    size_t allocate(size_t size);
+
+    /*
+     * Free the object at `addr`. Invalid and double frees are
+     * rejected. Returns true if the object was freed.
+     */
+    bool free_object(size_t addr);
+
+    /*
+     * Print per-cache slab utilization and internal fragmentation,
+     * compared with serving the same requests from raw buddy blocks.
+     */
+    void stats();
+
+private:
+    BuddyAllocator *pages;                     // Backing page allocator
+    std::vector<SlabCache> caches;             // Caches in creation order
+    std::vector<Slab> slabs;                   // Slab records (reused when released)
+    std::vector<int> spare;                    // Released slab record indices
+    std::unordered_map<size_t, int> slab_at;   // Slab base address → slab index
+
+    int grow(int cache);
+    void move(Slab &slab, int state);
+    void release(int slab);
+};
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef TAG_HEAP_H
+#define TAG_HEAP_H
+
+#include <cstddef>
+#include "common.h"
+#include "free_stats.h"
+
+/*
+ * TagHeap
+ *
+ * Contiguous boundary-tag representation of the simulated memory,
+ * an alternative to the node-per-block std::list backend.
+ *
+ * As in a real allocator, the simulated memory is a byte arena and
+ * every block carries a one-word boundary tag in its first word
+ * (header) and its last word (footer). Nothing is stored between
+ * block boundaries, so:
+ *  - The next block is found by adding the block size to its start
+ *  - The previous block is found through the footer just before it
+ *  - Coalescing is O(1) and no host memory is allocated per malloc
+ *
+ * Block sizes are multiples of the tag word, and an allocated block
+ * spans at least a header and a footer. A free block's header and
+ * footer both hold its size and free flag; an allocated block's
+ * footer holds its block ID instead, so the owner of a block is
+ * read from the arena.
+ *
+ * Live blocks are also recorded in a slot table keyed by block ID,
+ * sized at init for the most blocks the arena can hold, so allocate
+ * and release never allocate host memory.
+ *
+ * Placement walks the implicit block list header to header.
+ * The arena and slot table are zero-filled lazily by the host, so
+ * initialization does not touch every simulated byte.
+ */
+class TagHeap {
+public:
+    /*
+     * Sentinel returned when no block is found.
+     */
+    static const size_t NONE = (size_t)-1;
+
+    /*
+     * Size of a boundary tag; block sizes are multiples of it.
+     */
+    static const size_t WORD = sizeof(size_t);
+
+    /*
+     * Smallest allocated block: a header and a footer.
+     */
+    static const size_t MIN_BLOCK = 2 * WORD;
+
+    TagHeap() {}
+    ~TagHeap();
+
+    /*
+     * The arena is owned by the heap and not copyable.
+     */
+    TagHeap(const TagHeap &) = delete;
+    TagHeap &operator=(const TagHeap &) = delete;
+
+    /*
+     * Reset the arena to a single free block of `size` bytes
+     * (a multiple of WORD). A size of 0 releases the arena.
+     */
+    void init(size_t size);
+
+    /*
+     * Placement searches over the implicit block list.
+     * Return the start address of the chosen free block, or NONE.
+     */
+    size_t first_fit(size_t size) const;
+    size_t best_fit(size_t size) const;
+    size_t worst_fit(size_t size) const;
+
+    /*
+     * First free block at or above `from` that fits, wrapping
+     * around to the start of the arena (Next Fit).
+     */
+    size_t next_fit(size_t from, size_t size) const;
+
+    /*
+     * Allocate `size` bytes (a multiple of WORD, at least MIN_BLOCK)
+     * from the front of the free block at `start`, splitting off the
+     * remainder, under block ID `id` for a request of `requested` bytes.
+     */
+    void allocate(size_t start, size_t size, int id, size_t requested);
+
+    /*
+     * Free the allocated block at `start` and coalesce it with
+     * free neighbours. Returns the ID of the freed block; if
+     * `merged` is given it receives the resulting free block.
+     */
+    int release(size_t start, Block *merged = nullptr);
+
+    /*
+     * Start address of the allocated block with ID `id`, or NONE.
+     */
+    size_t find(int id) const;
+
+    /*
+     * True if an allocated block starts at `start`.
+     */
+    bool allocated_at(size_t start) const;
+
+    /*
+     * Decode the block whose header is at `start`.
+     */
+    Block block_at(size_t start) const;
+
+    /*
+     * Size of the largest free block (0 if none).
+     */
+    size_t largest_free() const;
+
+    /*
+     * Size of the managed arena in bytes.
+     */
+    size_t size() const { return length; }
+
+    /*
+     * Free-block totals and histogram, kept up to date by
+     * init, allocate and release.
+     */
+    FreeSpaceStats free_space;
+
+private:
+    /*
+     * Per-allocation data of a live block. ID 0 marks an empty slot.
+     */
+    struct Slot {
+        int id;             // Block ID
+        size_t start;       // Header address
+        size_t requested;   // Requested size
+    };
+
+    unsigned char *arena = nullptr;   // Simulated memory
+    size_t length = 0;                // Arena size in bytes
+
+    /*
+     * Open-addressed table of live blocks: block `id` lives at the
+     * first slot from id % slot_count on (linear probing). It has one
+     * slot more than the arena can hold blocks, so probes always end
+     * at an empty slot. Block IDs are sequential, so they rarely collide.
+     */
+    Slot *slots = nullptr;
+    size_t slot_count = 0;
+
+    size_t load(size_t addr) const;
+    void store(size_t addr, size_t word);
+    void write_free(size_t start, size_t size);
+
+    const Slot *find_slot(int id) const;
+    void insert_slot(int id, size_t start, size_t requested);
+    void erase_slot(int id);
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef TLB_H
+#define TLB_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * TlbEntry
+ *
+ * One cached translation: virtual page → physical frame.
+ */
+struct TlbEntry {
+    bool valid;          // Entry holds a translation
+    size_t page;         // Virtual page number (used as the tag)
+    int frame;           // Physical frame the page maps to
+    int last_used;       // Timestamp used for LRU replacement
+};
+
+/*
+ * Supported TLB replacement policies.
+ */
+enum TlbPolicy {
+    TLB_LRU,      // Least Recently Used entry in the set
+    TLB_RANDOM    // Pseudo-random entry in the set
+};
+
+/*
+ * TLB
+ *
+ * Set-associative translation lookaside buffer. The set is chosen
+ * by page number modulo the number of sets; a fully associative
+ * TLB has associativity == entries. A TLB with 0 entries is
+ * disabled and misses every lookup without counting it.
+ */
+class TLB {
+public:
+    /*
+     * Configuration parameters
+     */
+    int entries;          // Total number of entries
+    int associativity;    // Entries per set
+    TlbPolicy policy;     // Replacement policy
+    int sets_count;       // entries / associativity
+
+    std::vector<std::vector<TlbEntry>> sets;
+
+    /*
+     * Statistics counters
+     */
+    int hits = 0;            // Lookups that found the page
+    int misses = 0;          // Lookups that did not
+    int invalidations = 0;   // Entries dropped by shootdowns
+
+    /*
+     * Constructor
+     *
+     * Builds an empty TLB. `entries` must be a multiple of
+     * `associativity` (or 0 to disable the TLB).
+     */
+    TLB(int entries, int associativity, TlbPolicy policy);
+
+    bool enabled() const { return entries > 0; }
+
+    /*
+     * Look up `page`. On a hit, store its frame in `frame`.
+     */
+    bool lookup(size_t page, int &frame);
+
+    /*
+     * Cache the translation page → frame, replacing an entry of
+     * the set according to the policy if the set is full.
+     */
+    void insert(size_t page, int frame);
+
+    /*
+     * Drop the translation of `page` (TLB shootdown).
+     * Returns true if an entry was invalidated.
+     */
+    bool invalidate(size_t page);
+
+    /*
+     * Drop every translation.
+     */
+    void flush();
+
+    /*
+     * Compute hit ratio as a percentage.
+     */
+    double hit_ratio() const
+    {
+        int total = hits + misses;
+        return total == 0 ? 0.0
+                          : (double)hits / total * 100.0;
+    }
+
+private:
+    int tick = 0;                  // Global timestamp for LRU
+    uint32_t seed = 2463534242u;   // xorshift32 state for TLB_RANDOM
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef TLSF_INDEX_H
+#define TLSF_INDEX_H
+
+#include <list>
+#include <cstdint>
+#include <cstddef>
+#include "common.h"
+
+/*
+ * TlsfIndex
+ *
+ * Two-Level Segregated Fit free-block index.
+ *
+ * Free blocks are binned by size:
+ *  - First level (FL): power-of-two size class, floor(log2(size))
+ *  - Second level (SL): 2^SL_LOG2 linear subdivisions of each class
+ *
+ * A bitmap of non-empty first-level classes and one bitmap of
+ * non-empty second-level bins per class let a search find a
+ * suitable bin with two find-first-set operations, so insert,
+ * erase and search are all O(1).
+ *
+ * Searches round the request up to the next bin boundary
+ * ("good fit"), so the head block of any bin found is guaranteed
+ * to be large enough. Fragmentation is bounded by the bin width.
+ *
+ * Bins are intrusive doubly linked lists threaded through the
+ * blocks' bin_prev / bin_next links, so insert and erase touch
+ * only the block and its bin neighbours and never the host heap.
+ */
+class TlsfIndex {
+public:
+    typedef std::list<Block>::iterator BlockRef;
+
+    /*
+     * Index geometry.
+     */
+    static const int SL_LOG2 = 4;               // log2 of second-level bins
+    static const int SL_COUNT = 1 << SL_LOG2;   // Second-level bins per class
+    static const int FL_COUNT = 64;             // First-level classes
+
+    TlsfIndex();
+
+    /*
+     * Remove all indexed blocks.
+     */
+    void clear();
+
+    /*
+     * Add / remove a free block. A block must be erased before
+     * its size is modified.
+     */
+    void insert(BlockRef block);
+    void erase(BlockRef block);
+
+    /*
+     * Find a free block of at least `size` bytes.
+     * Returns false if no suitable bin is populated.
+     */
+    bool find(size_t size, BlockRef &out) const;
+
+    /*
+     * Size of the largest indexed block (0 if none). Only the
+     * highest non-empty bin is searched.
+     */
+    size_t largest() const;
+
+    /*
+     * Number of indexed free blocks and of non-empty bins.
+     */
+    size_t count() const { return indexed; }
+    int bins_used() const;
+
+private:
+    uint64_t fl_bitmap;                  // Non-empty first-level classes
+    uint32_t sl_bitmap[FL_COUNT];        // Non-empty bins per class
+
+    BlockRef bins[FL_COUNT][SL_COUNT];   // Head of each non-empty bin
+    size_t indexed;                      // Number of indexed blocks
+
+    static void mapping(size_t size, int &fl, int &sl);
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Binary allocation trace format
+ *
+ * Written by the LD_PRELOAD tracer (libmemtrace.so) and read by
+ * trace_replay. A trace is one TraceHeader followed by fixed-size
+ * TraceRecords in call order, all in host byte order.
+ */
+const char TRACE_MAGIC[8] = { 'M', 'E', 'M', 'T', 'R', 'A', 'C', 'E' };
+const uint32_t TRACE_VERSION = 1;
+
+/*
+ * Traced calls.
+ */
+enum TraceOp {
+    TRACE_MALLOC,    // ptr = malloc(size)
+    TRACE_CALLOC,    // ptr = calloc(n, m), size = n * m
+    TRACE_REALLOC,   // ptr = realloc(old_ptr, size)
+    TRACE_FREE       // free(ptr)
+};
+
+struct TraceHeader {
+    char magic[8];          // TRACE_MAGIC
+    uint32_t version;       // TRACE_VERSION
+    uint32_t record_size;   // sizeof(TraceRecord)
+};
+
+struct TraceRecord {
+    uint64_t time_ns;   // Monotonic clock at the call
+    uint64_t ptr;       // Returned (or freed) pointer, 0 for NULL
+    uint64_t old_ptr;   // Pointer passed to realloc, else 0
+    uint64_t size;      // Requested bytes (0 for free)
+    uint32_t thread;    // Kernel thread ID of the caller
+    uint32_t op;        // TraceOp
+};
+
+/*
+ * Read the trace at `path` into `records`. Prints an error and
+ * returns false if the file is missing or not a trace.
+ */
+bool load_trace(const std::string &path, std::vector<TraceRecord> &records);
+
+/*
+ * Replay the trace at `path` through First, Best and Worst Fit on a
+ * `heap_size`-byte list heap (using the current heap's block layout)
+ * and through a buddy allocator. Traced pointers are mapped to the
+ * simulated blocks; each strategy reports fragmentation at `samples`
+ * points of the trace and its placement cost.
+ */
+void run_trace_replay(const std::string &path, size_t heap_size, int samples);
+
+/*
+ * Feed one malloc/free stream into every strategy at once, each on
+ * its own thread with a private heap, and print a side-by-side report
+ * plus the first operation whose outcome differs between strategies.
+ *
+ * `path` is either a binary trace or a command script whose
+ * `malloc <size>` and `free <id>` / `free 0x<address>` lines form
+ * the stream. The script is replayed on a reference heap, so IDs and
+ * addresses are the ones the CLI would have assigned. A `heap_size`
+ * of 0 takes the size from the script's `init memory` line.
+ */
+void run_compare(const std::string &path, size_t heap_size);
+
+#endif
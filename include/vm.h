@@ -2,7 +2,13 @@
 #define VM_H
 
 #include <vector>
+#include <deque>
+#include <set>
+#include <string>
+#include <utility>
+#include <cstdint>
 #include <cstddef>
+#include "tlb.h"
 
 /*
  * Page Table Entry (PTE)
@@ -15,6 +21,38 @@ struct PageTableEntry {
     int frame;           // Physical frame number mapped to this page
     int fifo_order;      // Timestamp for FIFO page replacement
     bool reference;      // Reference bit used by Clock replacement algorithm
+    bool dirty;          // Set by writes; a dirty page is written back on eviction
+};
+
+/*
+ * Kind of memory access being translated.
+ */
+enum AccessType {
+    READ_ACCESS,
+    WRITE_ACCESS
+};
+
+/*
+ * One table of the radix page table.
+ *
+ * Interior tables hold the index of the next-level table per entry
+ * (-1 while that part of the address space is untouched); leaf
+ * tables hold the page table entries themselves.
+ */
+struct PageTableNode {
+    std::vector<int> child;                // Next-level table per entry (interior)
+    std::vector<PageTableEntry> entries;   // Page table entries (leaf)
+};
+
+/*
+ * Replacement state kept per physical frame.
+ */
+struct FrameState {
+    int lru_prev = -1;        // Next more recently used frame (LRU list)
+    int lru_next = -1;        // Next less recently used frame (LRU list)
+    uint32_t counter = 0;     // NFU reference count / aging register
+    size_t last_use = 0;      // Virtual time of the last reference (WSClock)
+    size_t next_use = 0;      // Position of the next reference (OPT)
 };
 
 /*
@@ -22,9 +60,23 @@ struct PageTableEntry {
  */
 enum PageReplacement {
     FIFO_REPL,           // First-In First-Out replacement
-    CLOCK_REPL           // Clock (Second-Chance) replacement
+    CLOCK_REPL,          // Clock (Second-Chance) replacement
+    LRU_REPL,            // Exact Least Recently Used
+    NFU_REPL,            // Not Frequently Used (LFU approximation)
+    AGING_REPL,          // NFU with aging (shift-right reference history)
+    WSCLOCK_REPL,        // Clock restricted to the working-set window
+    OPT_REPL             // Belady's optimal, needs the future reference string
 };
 
+const int REPLACEMENT_POLICIES = OPT_REPL + 1;
+
+/*
+ * CLI name of a replacement policy ("fifo", "clock", ..., "opt"),
+ * and the reverse lookup. Returns false for unknown names.
+ */
+const char *replacement_name(PageReplacement policy);
+bool parse_replacement(const std::string &name, PageReplacement &policy);
+
 /*
  * VirtualMemory
  *
@@ -44,25 +96,61 @@ public:
     int num_frames;       // Number of physical frames available
     PageReplacement policy; // Selected page replacement policy
     int clock_hand;       // Pointer used for Clock replacement
+    int va_bits = 16;     // Virtual address width in bits
+    int levels = 2;       // Page table levels walked per translation
+    int aging_interval = 16;   // References between NFU / aging counter updates
+    int ws_window = 32;        // WSClock working-set window (references)
 
     /*
      * Disk simulation parameters
      */
-    int disk_accesses;          // Number of simulated disk accesses (page faults)
+    int disk_accesses;          // Number of simulated disk accesses (page-ins + page-outs)
+    int page_ins = 0;           // Pages read from disk (one per page fault)
+    int page_outs = 0;          // Dirty pages written back to disk
     const int DISK_LATENCY = 100; // Symbolic disk access latency (cycles)
 
     /*
      * Core data structures
      */
-    std::vector<PageTableEntry> page_table; // Page table indexed by virtual page number
-    std::vector<int> frame_to_page;         // Reverse mapping: frame → page
+    std::vector<PageTableNode> tables;      // Radix page table, tables[0] is the root
+    std::vector<size_t> frame_to_page;      // Reverse mapping: frame → page (NO_PAGE if free)
+    static const size_t NO_PAGE = (size_t)-1;
+    std::vector<int> free_frames;           // Stack of free frames, lowest on top
+    std::deque<size_t> fifo_queue;          // Resident pages in load order (FIFO only)
+    std::vector<FrameState> frame_state;    // Replacement state per frame
+    int lru_head = -1;                      // Most recently used frame
+    int lru_tail = -1;                      // Least recently used frame
+
+    /*
+     * Translation lookaside buffers, consulted before the page table.
+     * The optional second-level STLB (disabled when it has 0 entries)
+     * is checked on a TLB miss; a page walk fills both.
+     */
+    TLB tlb{16, 4, TLB_LRU};
+    TLB stlb{0, 1, TLB_LRU};
+
+    /*
+     * Translation latencies (cycles)
+     */
+    int tlb_latency = 1;     // TLB lookup
+    int stlb_latency = 7;    // Additional cost of an STLB lookup
+    int level_latency = 15;  // Page table read per level walked
 
     /*
      * Statistics counters
      */
     int fifo_tick = 0;     // Global time counter for FIFO ordering
+    size_t vtime = 0;      // References made (virtual time)
     int page_faults = 0;   // Total number of page faults
     int page_hits = 0;     // Total number of page hits
+    int reads = 0;         // Read accesses translated
+    int writes = 0;        // Write accesses translated
+    int translations = 0;  // Valid addresses translated
+    int page_walks = 0;    // Translations that missed every TLB
+    long walk_levels = 0;  // Page table levels read by those walks
+    int shootdowns = 0;    // Evictions that invalidated TLB entries
+    long translation_cycles = 0;   // Cycles spent translating (excluding disk)
+    long miss_cycles = 0;          // Part of it caused by TLB misses
 
     /*
      * Constructor
@@ -71,6 +159,8 @@ public:
      *  - A fixed number of frames
      *  - A fixed page size
      *  - A selected page replacement policy
+     *
+     * The address space starts at 16 bits with a 2-level page table.
      */
     VirtualMemory(int frames, int page_size, PageReplacement policy);
 
@@ -89,11 +179,48 @@ public:
      *
      * Steps:
      *  - Extract page number and offset
-     *  - Check page table validity
+     *  - Look the page up in the TLB, then the STLB
+     *  - On a miss, walk the page table and fill the TLBs
      *  - Handle page faults if necessary
-     *  - Apply replacement policy if frames are full
+     *  - Apply replacement policy if frames are full, shooting
+     *    the victim page down from the TLBs and writing it back
+     *    if it is dirty
+     *  - Mark the page dirty on a write
+     */
+    size_t translate(size_t virtual_address,
+                     AccessType type = READ_ACCESS);
+
+    /*
+     * Replace the TLB / STLB with empty ones of the given geometry.
+     * An STLB with 0 entries is disabled. Translation counters
+     * restart from zero; page hit and fault counters are kept.
+     */
+    void configure_tlb(int entries, int associativity, TlbPolicy policy);
+    void configure_stlb(int entries, int associativity);
+
+    /*
+     * Replace the address space with an empty one `bits` wide whose
+     * page table has `depth` levels, splitting the virtual page number
+     * bits as evenly as possible (the root takes any remainder).
+     * Frames are released, the TLBs flushed and all counters reset.
+     * Returns false if the geometry is unsupported (up to 48 bits,
+     * 1 to 5 levels, at least one index bit per level).
+     */
+    bool set_address_space(int bits, int depth);
+
+    /*
+     * Switch the replacement policy. The address space is rebuilt
+     * empty with the same geometry, as with set_address_space.
+     */
+    void set_policy(PageReplacement p);
+
+    /*
+     * Give OPT the future: the virtual addresses this instance will
+     * translate, in order. Each is paired with the position of the
+     * next reference to the same page. Without a future, OPT treats
+     * every page as never used again.
      */
-    size_t translate(size_t virtual_address);
+    void set_future(const std::vector<size_t> &addresses);
 
     /*
      * Returns total virtual memory size in bytes.
@@ -109,10 +236,49 @@ public:
      * Print virtual memory statistics including:
      *  - Page hits
      *  - Page faults
-     *  - Disk accesses
+     *  - Disk accesses, split into page-ins and page-outs
+     *  - Read and write accesses
      *  - Fault rate
+     *  - TLB / STLB hits and misses, page walks, shootdowns
+     *    and the average TLB miss penalty
+     *  - Page table geometry and the memory its tables occupy
      */
     void stats();
+
+private:
+    std::vector<int> level_bits;    // Index bits per level, root first
+    std::vector<int> level_shift;   // Shift of each level's index in the page number
+
+    PageTableEntry *find_pte(size_t page, int &read);
+    PageTableEntry &map_pte(size_t page);
+    int new_table(int level);
+
+    /*
+     * OPT state: next_reference[i] is the position of the next
+     * reference to the page referenced at position i (NEVER if none);
+     * by_next_use orders resident frames by their next reference.
+     */
+    static const size_t NEVER = (size_t)-1;
+    std::vector<size_t> next_reference;
+    std::set<std::pair<size_t, int>> by_next_use;
+
+    void touch(size_t page, int frame, size_t now, AccessType type);
+    void write_back(PageTableEntry &pte);
+    int choose_victim(size_t now);
+    void age_counters();
+    void lru_unlink(int frame);
+    void lru_push_front(int frame);
+    void shootdown(size_t page);
+    void reset_translation_stats();
 };
 
+/*
+ * Replay the `access` lines of a CLI script (reads, or writes when
+ * marked `w`) through every replacement policy, OPT included, and
+ * report page faults and writebacks against the OPT lower bound.
+ * `frames` <= 0 keeps the frame count of `like`.
+ */
+void run_vm_compare(const std::string &path, int frames,
+                    const VirtualMemory &like);
+
 #endif
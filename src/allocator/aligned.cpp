@@ -0,0 +1,114 @@
+#include "allocator.h"
+#include <iostream>
+
+using namespace std;
+
+/*
+ * Allocates memory at an aligned address (posix_memalign style).
+ *
+ * Candidate free blocks are visited in address order through the
+ * address-ordered free index, skipping blocks too small for the
+ * request. The payload, which follows the block header, is what
+ * gets aligned: the first block that still holds the request once
+ * its payload address is rounded up to `align` is used. The bytes
+ * before the block start are split off as a free block of their
+ * own, and the rest is carved as usual.
+ *
+ * A gap smaller than min_split would leave a sliver the split rule
+ * forbids elsewhere, so the placement then moves on to the next
+ * aligned payload address that leaves a gap of at least min_split bytes.
+ */
+bool Heap::place_aligned(size_t size, size_t align, Block &out)
+{
+    // Zero-byte requests are rejected: an empty block would share
+    // its address with a neighbour
+    if (size == 0 || backend != LIST_HEAP)
+        return false;
+
+    // Block size including header, footer and size-class rounding
+    size_t need = block_size_for(size);
+
+    activate_free_index(FIRST_FIT);
+
+    FreeIndex::BlockRef it;
+    size_t from = 0;
+    size_t offset = 0;
+    bool found = false;
+
+    while (free_index.first_fit_from(from, need, it))
+    {
+        size_t payload = it->start + header_size;
+        size_t aligned = (payload + align - 1) & ~(align - 1);
+        if (aligned > payload && aligned - payload < min_split)
+            aligned = (payload + min_split + align - 1) & ~(align - 1);
+        offset = aligned - payload;
+
+        if (aligned >= payload && offset <= it->size - need)
+        {
+            found = true;
+            break;
+        }
+        from = it->start + 1;
+    }
+
+    if (!found)
+        return false;
+
+    // Split off the unaligned front of the block as a free block
+    if (offset > 0)
+    {
+        unindex_free(it);
+
+        Block gap;
+        gap.start = it->start;
+        gap.size = offset;
+        gap.requested = 0;
+        gap.free = true;
+        gap.id = -1;
+
+        auto gap_it = memory_blocks.insert(it, gap);
+        block_by_address[gap.start] = gap_it;
+        index_free(gap_it);
+
+        it->start += offset;
+        it->size -= offset;
+        block_by_address[it->start] = it;
+        index_free(it);
+    }
+
+    out = *carve_block(it, need, size);
+    return true;
+}
+
+/*
+ * Aligned allocation front-end: validates the alignment, counts
+ * the request and reports the result.
+ */
+void Heap::malloc_aligned(size_t size, size_t align)
+{
+    if (backend != LIST_HEAP)
+    {
+        cout << "Aligned allocation requires the list heap "
+             << "(init memory <size>)\n";
+        return;
+    }
+
+    if (align == 0 || (align & (align - 1)))
+    {
+        cout << "Alignment must be a power of two\n";
+        return;
+    }
+
+    Block alloc;
+    if (!place_aligned_block(size, align, alloc))
+    {
+        cout << "Allocation failed\n";
+        return;
+    }
+
+    cout << "Allocated block id=" << alloc.id
+         << " at address=0x" << hex << alloc.start;
+    if (header_size > 0)
+        cout << " (payload 0x" << alloc.start + header_size << ")";
+    cout << dec << "\n";
+}
@@ -1,40 +1,85 @@
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <chrono>
+#include <vector>
 #include "allocator.h"
 
 using namespace std;
 
 /*
- * Global data structures used to simulate physical memory.
- * Memory is modeled as a list of variable-sized blocks.
+ * Heap used by the free-function allocator API.
  */
-list<Block> memory_blocks;
+Heap *current_heap = nullptr;
 
 /*
- * Total size of simulated physical memory (in bytes).
+ * Adds / removes a free block in the active index family and
+ * in the free-space totals.
  */
-size_t TOTAL_MEMORY = 0;
+void Heap::index_free(list<Block>::iterator it)
+{
+    if (index_family == TLSF_BINS)
+        tlsf_index.insert(it);
+    else
+        free_index.insert(it);
+    free_space.add(it->size);
+}
 
-/*
- * Monotonically increasing block ID assigned to each allocation.
- */
-int next_block_id = 1;
+void Heap::unindex_free(list<Block>::iterator it)
+{
+    if (index_family == TLSF_BINS)
+        tlsf_index.erase(it);
+    else
+        free_index.erase(it);
+    free_space.remove(it->size);
+}
 
 /*
- * Allocation statistics used for reporting success rate.
+ * Ensures the index used by `type` is the one being maintained.
+ * A switch between families re-indexes every free block (O(n)).
  */
-int alloc_requests = 0;
-int alloc_success = 0;
+void Heap::activate_free_index(AllocatorType type)
+{
+    IndexFamily wanted = (type == TLSF) ? TLSF_BINS : TREE_INDEX;
+    if (wanted == index_family)
+        return;
+
+    free_index.clear();
+    tlsf_index.clear();
+    index_family = wanted;
+
+    // The free-space totals are unchanged, so insert directly
+    for (auto it = memory_blocks.begin(); it != memory_blocks.end(); ++it)
+    {
+        if (!it->free)
+            continue;
+
+        if (index_family == TLSF_BINS)
+            tlsf_index.insert(it);
+        else
+            free_index.insert(it);
+    }
+}
 
 /*
  * Initializes the simulated physical memory as a single free block.
  * Any existing memory state is cleared.
  */
-void init_memory(size_t size)
+void Heap::init(size_t size, HeapBackend kind)
 {
+    backend = kind;
     memory_blocks.clear();
-    TOTAL_MEMORY = size;
+    free_index.clear();
+    tlsf_index.clear();
+    block_by_id.clear();
+    block_by_address.clear();
+    free_space.clear();
+    total_memory = size;
+    used_bytes = 0;
+    requested_bytes = 0;
+    rover = 0;
+    arenas.clear();
+    arena_by_block.clear();
 
     Block initial;
     initial.start = 0;
@@ -44,84 +89,541 @@ void init_memory(size_t size)
     initial.id = -1;
 
     memory_blocks.push_back(initial);
+    index_free(memory_blocks.begin());
+    block_by_address[0] = memory_blocks.begin();
+
+    // Contiguous boundary-tag arena (released when unused)
+    if (backend == TAGGED_HEAP)
+    {
+        memory_blocks.clear();
+        free_index.clear();
+        tlsf_index.clear();
+        block_by_address.clear();
+        free_space.clear();
 
-    cout << "Memory initialized with size: " << size << " bytes" << endl;
+        // The arena holds whole tag words
+        total_memory = size / TagHeap::WORD * TagHeap::WORD;
+        tag_heap.init(total_memory);
+    }
+    else
+    {
+        tag_heap.init(0);
+    }
 }
 
 /*
- * Frees an allocated block identified by its block ID.
- * Adjacent free blocks are coalesced to reduce external fragmentation.
+ * Block size for a request of `requested` bytes: the payload plus
+ * header and footer, rounded up to the size-class granularity.
+ * Tagged blocks are further rounded up to whole tag words, with room
+ * for at least a header and a footer tag.
+ * Returns (size_t)-1, which no block can satisfy, on overflow.
  */
-void free_block(int id)
+size_t Heap::block_size_for(size_t requested) const
 {
-    for (auto it = memory_blocks.begin(); it != memory_blocks.end(); ++it)
+    size_t overhead = header_size + footer_size;
+    if (requested > (size_t)-1 - overhead - granularity - TagHeap::MIN_BLOCK)
+        return (size_t)-1;
+
+    size_t size = requested + overhead;
+    if (granularity > 1)
+        size = (size + granularity - 1) / granularity * granularity;
+
+    if (backend == TAGGED_HEAP)
     {
-        if (!it->free && it->id == id)
-        {
-            // Mark block as free
-            it->free = true;
-            it->requested = 0;
-            it->id = -1;
+        size = (size + TagHeap::WORD - 1) / TagHeap::WORD * TagHeap::WORD;
+        if (size < TagHeap::MIN_BLOCK)
+            size = TagHeap::MIN_BLOCK;
+    }
+    return size;
+}
+
+/*
+ * Allocates a block of `size` bytes for a `requested`-byte request
+ * from the front of the free block at `it`. The block is reused in
+ * place as the allocated block and any remainder is inserted after
+ * it as a new free block, unless it is smaller than min_split, in
+ * which case the whole block is handed out.
+ */
+list<Block>::iterator Heap::carve_block(list<Block>::iterator it,
+                                        size_t size, size_t requested)
+{
+    unindex_free(it);
 
-            // Coalesce with previous block if free
-            if (it != memory_blocks.begin())
+    size_t remaining = it->size - size;
+    if (remaining < min_split)
+    {
+        size = it->size;
+        remaining = 0;
+    }
+
+    it->size = size;
+    it->requested = requested;
+    it->free = false;
+    it->id = next_block_id++;
+
+    alloc_success++;
+    used_bytes += it->size;
+    requested_bytes += it->requested;
+    block_by_id[it->id] = it;
+
+    // Insert remaining free block if unused space remains
+    if (remaining > 0)
+    {
+        Block rem;
+        rem.start = it->start + size;
+        rem.size = remaining;
+        rem.requested = 0;
+        rem.free = true;
+        rem.id = -1;
+
+        auto next = it;
+        ++next;
+        auto rem_it = memory_blocks.insert(next, rem);
+        index_free(rem_it);
+        block_by_address[rem.start] = rem_it;
+    }
+
+    return it;
+}
+
+/*
+ * Allocates from the boundary-tag arena at `start`, assigning the
+ * next block ID. Mirrors carve_block() for the TAGGED_HEAP backend.
+ */
+bool Heap::carve_tagged(size_t start, size_t size, size_t requested,
+                        Block &out)
+{
+    if (start == TagHeap::NONE)
+        return false;
+
+    // Hand out the whole block rather than leave a sliver
+    size_t available = tag_heap.block_at(start).size;
+    if (available - size < min_split)
+        size = available;
+
+    tag_heap.allocate(start, size, next_block_id++, requested);
+    alloc_success++;
+
+    out = tag_heap.block_at(start);
+    used_bytes += out.size;
+    requested_bytes += out.requested;
+    return true;
+}
+
+/*
+ * Frees the tagged-heap block at `start`, keeping the allocated-byte
+ * counters in step. Returns the freed block's ID.
+ */
+int Heap::release_tagged(size_t start)
+{
+    Block b = tag_heap.block_at(start);
+    used_bytes -= b.size;
+    requested_bytes -= b.requested;
+
+    Block merged;
+    int id = tag_heap.release(start, &merged);
+    settle_rover(merged.start, merged.size);
+    return id;
+}
+
+/*
+ * Keeps the Next Fit rover on a block boundary: if the free block
+ * [start, start + size) absorbed the block the rover pointed at,
+ * the rover moves back to the start of the merged block.
+ */
+void Heap::settle_rover(size_t start, size_t size)
+{
+    if (start < rover && rover < start + size)
+        rover = start;
+}
+
+/*
+ * Runs the silent placement of `type`.
+ */
+bool Heap::place(AllocatorType type, size_t size, Block &out)
+{
+    switch (type)
+    {
+    case FIRST_FIT: return place_first_fit(size, out);
+    case BEST_FIT:  return place_best_fit(size, out);
+    case WORST_FIT: return place_worst_fit(size, out);
+    case NEXT_FIT:  return place_next_fit(size, out);
+    default:        return place_tlsf(size, out);
+    }
+}
+
+/*
+ * Runs the silent placement `place`, counting the request in
+ * `stats` and timing the placement for stats().
+ *
+ * With auto_compact set, a failed request compacts the heap and is
+ * retried, provided the free space could hold it and the compaction
+ * moves no more than compact_budget bytes. Compaction time is part
+ * of the placement time.
+ */
+template <typename Place>
+bool Heap::place_counted(StrategyStats &stats, size_t size, Block &out,
+                         Place place)
+{
+    // Track allocation attempt
+    alloc_requests++;
+    stats.requests++;
+
+    auto begin = chrono::steady_clock::now();
+
+    bool ok = place(out);
+
+    if (!ok && auto_compact && size > 0)
+    {
+        size_t cost, free_bytes;
+        compaction_plan(cost, free_bytes);
+
+        // Nothing to gain if the free space is already one block
+        // or too small in total
+        if (cost > 0 && free_bytes >= size)
+        {
+            if (compact_budget != 0 && cost > compact_budget)
             {
-                auto prev = it;
-                --prev;
-                if (prev->free)
-                {
-                    prev->size += it->size;
-                    it = memory_blocks.erase(it);
-                    it = prev;
-                }
+                compactions_skipped++;
             }
-
-            // Coalesce with next block if free
-            auto next = it;
-            ++next;
-            if (next != memory_blocks.end() && next->free)
+            else
             {
-                it->size += next->size;
-                memory_blocks.erase(next);
+                compact();
+                ok = place(out);
+                if (ok)
+                    compaction_rescues++;
             }
+        }
+    }
 
-            cout << "Block " << id << " freed and merged\n";
-            return;
+    auto end = chrono::steady_clock::now();
+    stats.total_ns +=
+        chrono::duration_cast<chrono::nanoseconds>(end - begin).count();
+
+    if (ok)
+        stats.success++;
+    return ok;
+}
+
+/*
+ * Dispatches a request to the silent placement of `type`,
+ * counted under that strategy.
+ */
+bool Heap::place_block(AllocatorType type, size_t size, Block &out)
+{
+    return place_counted(strategy_stats[type], size, out,
+                         [&](Block &b) { return place(type, size, b); });
+}
+
+/*
+ * Aligned placement, counted under aligned_stats.
+ */
+bool Heap::place_aligned_block(size_t size, size_t align, Block &out)
+{
+    return place_counted(aligned_stats, size, out,
+                         [&](Block &b) { return place_aligned(size, align, b); });
+}
+
+/*
+ * Returns an allocated block to the free pool and coalesces it with
+ * free neighbours. All indexes are updated in O(1) (plus the
+ * O(log n) free-index update). Returns the freed block's ID.
+ */
+int Heap::release_block(list<Block>::iterator it)
+{
+    int id = it->id;
+
+    used_bytes -= it->size;
+    requested_bytes -= it->requested;
+
+    // Mark block as free
+    block_by_id.erase(id);
+    it->free = true;
+    it->requested = 0;
+    it->id = -1;
+
+    // Coalesce with previous block if free
+    if (it != memory_blocks.begin())
+    {
+        auto prev = it;
+        --prev;
+        if (prev->free)
+        {
+            unindex_free(prev);
+            block_by_address.erase(it->start);
+            prev->size += it->size;
+            memory_blocks.erase(it);
+            it = prev;
         }
     }
 
-    cout << "No allocated block with id = " << id << endl;
+    // Coalesce with next block if free
+    auto next = it;
+    ++next;
+    if (next != memory_blocks.end() && next->free)
+    {
+        unindex_free(next);
+        block_by_address.erase(next->start);
+        it->size += next->size;
+        memory_blocks.erase(next);
+    }
+
+    index_free(it);
+    settle_rover(it->start, it->size);
+    return id;
+}
+
+/*
+ * Frees an allocated block identified by its block ID.
+ * Adjacent free blocks are coalesced to reduce external fragmentation.
+ */
+void Heap::free_block(int id)
+{
+    int arena = arena_backed_by(id);
+    if (arena != -1)
+    {
+        cout << "Block " << id << " backs arena " << arena
+             << " (use arena_destroy)\n";
+        return;
+    }
+
+    if (release_id(id) == -1)
+    {
+        cout << "No allocated block with id = " << id << endl;
+        return;
+    }
+
+    cout << "Block " << id << " freed and merged\n";
+}
+
+/*
+ * Silently frees the allocated block with ID `id` on either backend.
+ * Returns the ID, or -1 if no such block is allocated.
+ */
+int Heap::release_id(int id)
+{
+    if (backend == TAGGED_HEAP)
+    {
+        size_t start = tag_heap.find(id);
+        return (start == TagHeap::NONE) ? -1 : release_tagged(start);
+    }
+
+    auto found = block_by_id.find(id);
+    if (found == block_by_id.end())
+        return -1;
+
+    return release_block(found->second);
+}
+
+/*
+ * Silently frees the allocated block starting at `address`.
+ * The address index resolves the block directly, without a list walk.
+ * Returns the freed block's ID, or -1 if no allocated block starts there.
+ */
+int Heap::release_address(size_t address)
+{
+    if (backend == TAGGED_HEAP)
+        return tag_heap.allocated_at(address) ? release_tagged(address) : -1;
+
+    auto found = block_by_address.find(address);
+    if (found == block_by_address.end() || found->second->free)
+        return -1;
+
+    return release_block(found->second);
+}
+
+/*
+ * ID of the allocated block starting at `address`, or -1.
+ */
+int Heap::allocated_id_at(size_t address) const
+{
+    if (backend == TAGGED_HEAP)
+        return tag_heap.allocated_at(address) ? tag_heap.block_at(address).id : -1;
+
+    auto found = block_by_address.find(address);
+    if (found == block_by_address.end() || found->second->free)
+        return -1;
+    return found->second->id;
 }
 
 /*
  * Frees a block based on its starting address.
- * Internally resolves the address to a block ID and reuses free_block().
  */
-void free_by_address(size_t address)
+void Heap::free_by_address(size_t address)
 {
-    for (auto it = memory_blocks.begin(); it != memory_blocks.end(); ++it)
+    // Arena regions are only released through arena_destroy
+    int owner = allocated_id_at(address);
+    int arena = (owner == -1) ? -1 : arena_backed_by(owner);
+    if (arena != -1)
+    {
+        cout << "Block " << owner << " backs arena " << arena
+             << " (use arena_destroy)\n";
+        return;
+    }
+
+    int id = release_address(address);
+    if (id == -1)
+    {
+        cout << "No allocated block starts at address 0x"
+             << hex << address << dec << endl;
+        return;
+    }
+
+    cout << "Block " << id << " freed and merged\n";
+}
+
+/*
+ * Visits every block in address order on the active backend.
+ * Tagged-heap blocks are decoded from their header tags.
+ */
+template <typename Visit>
+void Heap::for_each_block(Visit visit)
+{
+    if (backend == TAGGED_HEAP)
+    {
+        for (size_t a = 0; a < tag_heap.size(); )
+        {
+            Block b = tag_heap.block_at(a);
+            visit(b);
+            a += b.size;
+        }
+        return;
+    }
+
+    for (auto &b : memory_blocks)
+        visit(b);
+}
+
+/*
+ * Computes the bytes a compaction would move and the total free space.
+ */
+void Heap::compaction_plan(size_t &cost, size_t &free_bytes)
+{
+    size_t cursor = 0;
+    cost = 0;
+    free_bytes = 0;
+
+    for_each_block([&](const Block &b)
     {
-        if (!it->free && it->start == address)
+        if (b.free)
         {
-            int id = it->id;
-            free_block(id);
+            free_bytes += b.size;
             return;
         }
+
+        if (b.start != cursor)
+            cost += b.size;
+        cursor += b.size;
+    });
+}
+
+/*
+ * Compacts the heap in one address-ordered pass.
+ *
+ * Allocated blocks keep their list nodes (so block IDs and the ID
+ * index stay valid) and only their start addresses change. Free
+ * blocks are dropped and replaced by a single free block covering
+ * the remaining memory. The tagged backend is rebuilt by
+ * re-allocating the live blocks back to back.
+ */
+CompactionResult Heap::compact()
+{
+    CompactionResult result;
+    size_t cursor = 0;
+
+    if (backend == TAGGED_HEAP)
+    {
+        vector<Block> live;
+        for_each_block([&](const Block &b)
+        {
+            if (!b.free)
+                live.push_back(b);
+        });
+
+        tag_heap.init(total_memory);
+        for (const Block &b : live)
+        {
+            if (b.start != cursor)
+            {
+                result.relocation[b.start] = cursor;
+                result.bytes_moved += b.size;
+            }
+            tag_heap.allocate(cursor, b.size, b.id, b.requested);
+            cursor += b.size;
+        }
+    }
+    else
+    {
+        // Every free block is removed, so the free indexes start over
+        free_index.clear();
+        tlsf_index.clear();
+
+        for (auto it = memory_blocks.begin(); it != memory_blocks.end(); )
+        {
+            if (it->free)
+            {
+                block_by_address.erase(it->start);
+                it = memory_blocks.erase(it);
+                continue;
+            }
+
+            // New addresses only decrease, so `cursor` never collides
+            // with a block that has not been visited yet
+            if (it->start != cursor)
+            {
+                result.relocation[it->start] = cursor;
+                result.bytes_moved += it->size;
+
+                block_by_address.erase(it->start);
+                it->start = cursor;
+                block_by_address[cursor] = it;
+            }
+
+            cursor += it->size;
+            ++it;
+        }
+
+        free_space.clear();
+        if (cursor < total_memory)
+        {
+            Block rest;
+            rest.start = cursor;
+            rest.size = total_memory - cursor;
+            rest.requested = 0;
+            rest.free = true;
+            rest.id = -1;
+
+            auto rest_it = memory_blocks.insert(memory_blocks.end(), rest);
+            index_free(rest_it);
+            block_by_address[cursor] = rest_it;
+        }
+    }
+
+    // Arena regions move with their blocks
+    for (Arena &a : arenas)
+    {
+        auto moved = result.relocation.find(a.base - a.header);
+        if (a.block_id != -1 && moved != result.relocation.end())
+            a.base = moved->second + a.header;
     }
 
-    cout << "No allocated block starts at address 0x"
-         << hex << address << dec << endl;
+    // Resume Next Fit at the merged free space
+    rover = (cursor < total_memory) ? cursor : 0;
+
+    compactions++;
+    compacted_bytes += result.bytes_moved;
+    return result;
 }
 
 /*
  * Prints the current memory layout, showing allocated and free blocks.
  * This provides a visualization of fragmentation.
  */
-void dump_memory()
+void Heap::dump()
 {
     cout << "\nMemory Layout:\n";
 
-    for (auto &block : memory_blocks)
+    for_each_block([](const Block &block)
     {
         cout << "[0x"
              << hex << setw(4) << setfill('0') << block.start
@@ -135,45 +637,36 @@ void dump_memory()
             cout << "USED (id=" << dec << block.id << ")\n";
 
         cout << dec;
-    }
+    });
 }
 
 /*
- * Computes and reports memory statistics including:
+ * Reports memory statistics including:
  * - Memory utilization
  * - Internal fragmentation
  * - External fragmentation
  * - Allocation success rate
+ *
+ * Every figure is read from counters maintained by the allocate,
+ * free and coalesce paths, except the largest free block, which
+ * comes from the free-block index.
  */
-void stats()
+void Heap::stats()
 {
-    size_t used = 0;
-    size_t free_mem = 0;
-    size_t largest_free = 0;
-    size_t internal_frag = 0;
+    const FreeSpaceStats &fs = free_stats();
 
-    for (auto &b : memory_blocks)
-    {
-        if (b.free)
-        {
-            free_mem += b.size;
-            if (b.size > largest_free)
-                largest_free = b.size;
-        }
-        else
-        {
-            used += b.size;
-            internal_frag += (b.size - b.requested);
-        }
-    }
+    size_t used = used_bytes;
+    size_t free_mem = fs.free_bytes;
+    size_t largest = largest_free();
+    size_t internal_frag = used_bytes - requested_bytes;
 
-    double utilization = (double)used / TOTAL_MEMORY * 100;
+    double utilization = (double)used / total_memory * 100;
     double external_frag =
         (free_mem == 0) ? 0 :
-        (1.0 - (double)largest_free / free_mem) * 100;
+        (1.0 - (double)largest / free_mem) * 100;
 
     cout << "\n--- Memory Statistics ---\n";
-    cout << "Total memory: " << TOTAL_MEMORY << "\n";
+    cout << "Total memory: " << total_memory << "\n";
     cout << "Used memory: " << used << "\n";
     cout << "Free memory: " << free_mem << "\n";
     cout << "Memory utilization: " << utilization << "%\n";
@@ -181,4 +674,136 @@ void stats()
     cout << "External fragmentation: " << external_frag << "%\n";
     cout << "Allocation success rate: "
          << alloc_success << "/" << alloc_requests << "\n";
+
+    if (header_size || footer_size || granularity > 1 || min_split)
+        cout << "Block layout: " << header_size << "B header, "
+             << footer_size << "B footer, " << granularity
+             << "B granularity, " << min_split << "B min split\n";
+
+    // Side-by-side view of every strategy used on this workload
+    for (int t = 0; t < ALLOCATOR_TYPES; t++)
+    {
+        const StrategyStats &s = strategy_stats[t];
+        if (s.requests == 0)
+            continue;
+
+        cout << allocator_name((AllocatorType)t) << ": "
+             << s.success << "/" << s.requests << " allocations, "
+             << (double)s.total_ns / s.requests << " ns/op\n";
+    }
+    if (aligned_stats.requests > 0)
+        cout << "aligned: " << aligned_stats.success << "/"
+             << aligned_stats.requests << " allocations, "
+             << (double)aligned_stats.total_ns / aligned_stats.requests
+             << " ns/op\n";
+
+    if (compactions > 0 || compactions_skipped > 0)
+        cout << "Compactions: " << compactions << " ("
+             << compacted_bytes << " bytes moved, "
+             << compaction_rescues << " failed requests served, "
+             << compactions_skipped << " over budget)\n";
+
+    if (reallocs > 0)
+        cout << "Reallocs: " << reallocs << " (" << reallocs_in_place
+             << " in place, " << realloc_copied << " bytes copied)\n";
+
+    if (backend == LIST_HEAP && index_family == TLSF_BINS)
+        cout << "TLSF free blocks: " << tlsf_index.count()
+             << " in " << tlsf_index.bins_used() << " bins\n";
+}
+
+/*
+ * The list backend keeps its own totals; the tagged backend's
+ * live in the TagHeap.
+ */
+const FreeSpaceStats &Heap::free_stats() const
+{
+    return backend == TAGGED_HEAP ? tag_heap.free_space : free_space;
+}
+
+/*
+ * List backend: the root of the address treap, or the top TLSF bin.
+ * Tagged backend: the top histogram bucket.
+ */
+size_t Heap::largest_free() const
+{
+    if (backend == TAGGED_HEAP)
+        return tag_heap.largest_free();
+    return index_family == TLSF_BINS ? tlsf_index.largest()
+                                     : free_index.largest();
+}
+
+/*
+ * Prints the free-size histogram, one line per non-empty
+ * power-of-two bucket.
+ */
+void Heap::frag_histogram()
+{
+    const FreeSpaceStats &fs = free_stats();
+
+    cout << "\n--- Free Block Histogram ---\n";
+    cout << "Free blocks: " << fs.free_blocks
+         << ", free bytes: " << fs.free_bytes
+         << ", largest: " << largest_free() << "\n";
+
+    for (uint64_t mask = fs.nonempty_buckets(); mask != 0; mask &= mask - 1)
+    {
+        int k = __builtin_ctzll(mask);
+        size_t low = (size_t)1 << k;
+
+        cout << "[" << low << ", ";
+        if (k == FreeSpaceStats::BUCKETS - 1)
+            cout << "2^64";
+        else
+            cout << (low << 1);
+        cout << "): " << fs.blocks[k] << " blocks, "
+             << fs.bytes[k] << " bytes\n";
+    }
+}
+
+/*
+ * Returns the CLI name of an allocation strategy.
+ */
+const char *allocator_name(AllocatorType type)
+{
+    switch (type)
+    {
+    case FIRST_FIT: return "first_fit";
+    case BEST_FIT:  return "best_fit";
+    case WORST_FIT: return "worst_fit";
+    case NEXT_FIT:  return "next_fit";
+    default:        return "tlsf";
+    }
+}
+
+/*
+ * Allocator API: forwards to the current heap.
+ */
+void init_memory(size_t size, HeapBackend backend)
+{
+    current_heap->init(size, backend);
+
+    cout << "Memory initialized with size: " << current_heap->total_memory
+         << " bytes";
+    if (backend == TAGGED_HEAP)
+        cout << " (boundary-tag heap)";
+    cout << endl;
+}
+
+void malloc_first_fit(size_t size) { current_heap->malloc_first_fit(size); }
+void malloc_best_fit(size_t size)  { current_heap->malloc_best_fit(size); }
+void malloc_worst_fit(size_t size) { current_heap->malloc_worst_fit(size); }
+void malloc_next_fit(size_t size)  { current_heap->malloc_next_fit(size); }
+void malloc_tlsf(size_t size)      { current_heap->malloc_tlsf(size); }
+void malloc_aligned(size_t size, size_t align)
+{
+    current_heap->malloc_aligned(size, align);
 }
+
+void free_block(int id)            { current_heap->free_block(id); }
+void free_by_address(size_t addr)  { current_heap->free_by_address(addr); }
+void dump_memory()                 { current_heap->dump(); }
+void stats()                       { current_heap->stats(); }
+void frag_histogram()              { current_heap->frag_histogram(); }
+
+CompactionResult compact_memory()  { return current_heap->compact(); }
@@ -0,0 +1,213 @@
+#include "allocator.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+
+using namespace std;
+
+/*
+ * Region (arena) allocation.
+ *
+ * An arena is one ordinary heap block placed with any strategy.
+ * Objects are carved from it by advancing a bump pointer, rounded
+ * up to the heap's granularity, so an allocation is a bounds check
+ * and an addition, and no per-object header, split or index update
+ * is needed. Individual objects are
+ * never freed; arena_reset rewinds the bump pointer, releasing
+ * every object at once in constant time.
+ */
+
+/*
+ * Carves a new arena of `capacity` bytes from the heap. The region
+ * is the block's payload: it starts after the simulated block
+ * header and ends before the footer.
+ */
+int Heap::arena_create(size_t capacity, AllocatorType type)
+{
+    Block region;
+    if (!place_block(type, capacity, region))
+        return -1;
+
+    Arena a;
+    a.block_id = region.id;
+    a.header = header_size;
+    a.base = region.start + header_size;
+    a.capacity = capacity;
+
+    arenas.push_back(a);
+    arena_by_block[a.block_id] = (int)arenas.size() - 1;
+    return (int)arenas.size() - 1;
+}
+
+/*
+ * Bump-allocates `size` bytes from an arena.
+ */
+size_t Heap::arena_alloc(int arena, size_t size)
+{
+    if (arena < 0 || (size_t)arena >= arenas.size() ||
+        arenas[arena].block_id == -1)
+        return (size_t)-1;
+
+    // Objects start on the same granularity as heap blocks
+    Arena &a = arenas[arena];
+    size_t addr = a.base + a.offset;
+    if (granularity > 1)
+        addr = (addr + granularity - 1) / granularity * granularity;
+
+    size_t start = addr - a.base;
+    if (size == 0 || start > a.capacity || size > a.capacity - start)
+    {
+        a.failures++;
+        return (size_t)-1;
+    }
+
+    a.offset = start + size;
+    a.objects++;
+    a.total_objects++;
+    a.requested += size;
+    if (a.offset > a.peak)
+        a.peak = a.offset;
+    return addr;
+}
+
+/*
+ * Frees every object of an arena by rewinding its bump pointer.
+ */
+bool Heap::arena_reset(int arena)
+{
+    if (arena < 0 || (size_t)arena >= arenas.size() ||
+        arenas[arena].block_id == -1)
+        return false;
+
+    Arena &a = arenas[arena];
+    a.offset = 0;
+    a.objects = 0;
+    a.requested = 0;
+    a.resets++;
+    return true;
+}
+
+/*
+ * Returns an arena's region to the heap. The arena ID is retired.
+ */
+bool Heap::arena_destroy(int arena)
+{
+    if (arena < 0 || (size_t)arena >= arenas.size() ||
+        arenas[arena].block_id == -1)
+        return false;
+
+    release_id(arenas[arena].block_id);
+    arena_by_block.erase(arenas[arena].block_id);
+    arenas[arena].block_id = -1;
+    return true;
+}
+
+/*
+ * Returns the arena backed by heap block `id`, or -1.
+ */
+int Heap::arena_backed_by(int id) const
+{
+    auto found = arena_by_block.find(id);
+    return found == arena_by_block.end() ? -1 : found->second;
+}
+
+/*
+ * Prints usage of every live arena.
+ */
+void Heap::arena_stats()
+{
+    cout << "\n--- Arena Statistics ---\n";
+
+    int live = 0;
+    for (size_t i = 0; i < arenas.size(); i++)
+    {
+        const Arena &a = arenas[i];
+        if (a.block_id == -1)
+            continue;
+        live++;
+
+        cout << "Arena " << i << " (block " << a.block_id << " at 0x"
+             << hex << a.base << dec << "): "
+             << a.offset << "/" << a.capacity << " bytes used, "
+             << a.objects << " objects, peak " << a.peak << " bytes\n";
+        cout << "  " << a.total_objects << " allocations, "
+             << a.failures << " failed, " << a.resets << " resets\n";
+    }
+
+    if (live == 0)
+        cout << "No arenas\n";
+}
+
+/*
+ * Compares per-object frees with an arena reset on a per-request
+ * workload: every request allocates `objects` small objects and
+ * then releases all of them. Both runs use a private heap.
+ */
+void run_arena_benchmark(int requests, int objects)
+{
+    const size_t heap_size = (size_t)1 << 24;
+    mt19937 rng(42);
+
+    vector<size_t> sizes(objects);
+    size_t request_bytes = 0;
+    for (int i = 0; i < objects; i++)
+    {
+        sizes[i] = 16 + rng() % 241;
+        request_bytes += sizes[i];
+    }
+
+    // Per-object malloc and free on the heap (First Fit)
+    Heap heap;
+    heap.init(heap_size);
+    vector<size_t> live(objects);
+    double alloc_ns = 0, free_ns = 0;
+
+    for (int r = 0; r < requests; r++)
+    {
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < objects; i++)
+        {
+            Block b;
+            heap.place_first_fit(sizes[i], b);
+            live[i] = b.start;
+        }
+        auto t1 = chrono::steady_clock::now();
+        for (int i = 0; i < objects; i++)
+            heap.release_address(live[i]);
+        auto t2 = chrono::steady_clock::now();
+
+        alloc_ns += chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count();
+        free_ns += chrono::duration_cast<chrono::nanoseconds>(t2 - t1).count();
+    }
+
+    // The same objects bump-allocated from one arena, reset per request
+    Heap arena_heap;
+    arena_heap.init(heap_size);
+    int arena = arena_heap.arena_create(request_bytes);
+    double bump_ns = 0, reset_ns = 0;
+
+    for (int r = 0; r < requests; r++)
+    {
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < objects; i++)
+            arena_heap.arena_alloc(arena, sizes[i]);
+        auto t1 = chrono::steady_clock::now();
+        arena_heap.arena_reset(arena);
+        auto t2 = chrono::steady_clock::now();
+
+        bump_ns += chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count();
+        reset_ns += chrono::duration_cast<chrono::nanoseconds>(t2 - t1).count();
+    }
+
+    cout << requests << " requests x " << objects << " objects ("
+         << request_bytes << " bytes per request)\n";
+    cout << fixed << setprecision(1);
+    cout << "Per-object free: " << alloc_ns / requests << " ns alloc + "
+         << free_ns / requests << " ns free per request\n";
+    cout << "Arena reset:     " << bump_ns / requests << " ns alloc + "
+         << reset_ns / requests << " ns free per request\n";
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
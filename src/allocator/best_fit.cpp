@@ -6,71 +6,55 @@ using namespace std;
 /*
  * Allocates memory using the Best Fit strategy.
  *
- * The allocator scans all free memory blocks and selects the
- * smallest block that can satisfy the allocation request.
- * This minimizes internal fragmentation but requires a full
- * traversal of the memory block list.
+ * The allocator selects the smallest free block that can satisfy
+ * the allocation request, preferring the lowest address on ties.
+ * This minimizes leftover space. The size-ordered free index
+ * answers the query with a single O(log n) lower-bound search
+ * instead of a full traversal of the memory block list.
  *
  * If the selected block is larger than the request, it is split
  * into an allocated block and a remaining free block.
+ *
+ * On the boundary-tag backend the implicit block list is scanned.
  */
-void malloc_best_fit(size_t size)
+bool Heap::place_best_fit(size_t size, Block &out)
 {
-    // Iterator pointing to the best (smallest suitable) free block
-    auto best = memory_blocks.end();
-
-    // Track allocation attempt
-    alloc_requests++;
-
-    // Search for the smallest free block that fits the request
-    for (auto it = memory_blocks.begin(); it != memory_blocks.end(); ++it)
-    {
-        if (it->free && it->size >= size)
-        {
-            if (best == memory_blocks.end() || it->size < best->size)
-                best = it;
-        }
-    }
+    // Zero-byte requests are rejected: an empty block would share
+    // its address with a neighbour
+    if (size == 0)
+        return false;
+
+    // Block size including header, footer and size-class rounding
+    size_t need = block_size_for(size);
+
+    // Boundary-tag heap: walk the implicit block list
+    if (backend == TAGGED_HEAP)
+        return carve_tagged(tag_heap.best_fit(need), need, size, out);
+
+    // Find the smallest free block that fits the request
+    activate_free_index(BEST_FIT);
+    FreeIndex::BlockRef it;
+    if (!free_index.best_fit(need, it))
+        return false;
+
+    // Allocate from the selected block, splitting off the remainder
+    out = *carve_block(it, need, size);
+    return true;
+}
 
-    // No suitable free block found
-    if (best == memory_blocks.end())
+/*
+ * Best Fit front-end: places the request and reports the result.
+ */
+void Heap::malloc_best_fit(size_t size)
+{
+    Block alloc;
+    if (!place_block(BEST_FIT, size, alloc))
     {
+        // No suitable free block found
         cout << "Allocation failed\n";
         return;
     }
 
-    // Create allocated block
-    Block alloc;
-    alloc.start = best->start;
-    alloc.size = size;
-    alloc.requested = size;
-    alloc.free = false;
-    alloc.id = next_block_id++;
-
-    // Update allocation success counter
-    alloc_success++;
-
-    // Preserve original block size for splitting
-    size_t original_size = best->size;
-
-    // Replace the selected free block with the allocated block
-    best = memory_blocks.erase(best);
-    memory_blocks.insert(best, alloc);
-
-    // Insert remaining free block if unused space remains
-    size_t remaining = original_size - size;
-    if (remaining > 0)
-    {
-        Block rem;
-        rem.start = alloc.start + size;
-        rem.size = remaining;
-        rem.requested = 0;
-        rem.free = true;
-        rem.id = -1;
-
-        memory_blocks.insert(best, rem);
-    }
-
     // Report allocation result
     cout << "Allocated block id=" << alloc.id
          << " at address=0x"
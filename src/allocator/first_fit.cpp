@@ -6,62 +6,57 @@ using namespace std;
 /*
  * Allocates memory using the First Fit strategy.
  *
- * The allocator scans the memory block list from the beginning
- * and selects the first free block that can satisfy the request.
+ * The allocator selects the lowest-addressed free block that can
+ * satisfy the request. Instead of scanning the block list, it
+ * descends the address-ordered free index, whose nodes record the
+ * largest free block in their subtree, giving O(log n) placement.
+ *
  * If the selected block is larger than the request, it is split
  * into an allocated block and a remaining free block.
+ *
+ * On the boundary-tag backend the same rule is applied while walking
+ * block headers in address order.
  */
-void malloc_first_fit(size_t request_size)
+bool Heap::place_first_fit(size_t size, Block &out)
 {
-    // Track allocation attempt
-    alloc_requests++;
+    // Zero-byte requests are rejected: an empty block would share
+    // its address with a neighbour
+    if (size == 0)
+        return false;
+
+    // Block size including header, footer and size-class rounding
+    size_t need = block_size_for(size);
+
+    // Boundary-tag heap: walk the implicit block list
+    if (backend == TAGGED_HEAP)
+        return carve_tagged(tag_heap.first_fit(need), need, size, out);
+
+    // Select the first free block large enough
+    activate_free_index(FIRST_FIT);
+    FreeIndex::BlockRef it;
+    if (!free_index.first_fit(need, it))
+        return false;
+
+    // Allocate from the selected block, splitting off the remainder
+    out = *carve_block(it, need, size);
+    return true;
+}
 
-    // Traverse memory blocks in address order
-    for (auto it = memory_blocks.begin(); it != memory_blocks.end(); ++it)
+/*
+ * First Fit front-end: places the request and reports the result.
+ */
+void Heap::malloc_first_fit(size_t request_size)
+{
+    Block allocated;
+    if (!place_block(FIRST_FIT, request_size, allocated))
     {
-        // Select the first free block large enough
-        if (it->free && it->size >= request_size)
-        {
-            // Create allocated block
-            Block allocated;
-            allocated.start = it->start;
-            allocated.size = request_size;
-            allocated.requested = request_size;
-            allocated.free = false;
-            allocated.id = next_block_id++;
-
-            // Update allocation success counter
-            alloc_success++;
-
-            // Calculate remaining space after allocation
-            size_t remaining_size = it->size - request_size;
-
-            // Replace original free block with allocated block
-            it = memory_blocks.erase(it);
-            memory_blocks.insert(it, allocated);
-
-            // Insert remaining free block if space remains
-            if (remaining_size > 0)
-            {
-                Block remaining;
-                remaining.start = allocated.start + request_size;
-                remaining.size = remaining_size;
-                remaining.requested = 0;
-                remaining.free = true;
-                remaining.id = -1;
-
-                memory_blocks.insert(it, remaining);
-            }
-
-            // Report allocation result
-            cout << "Allocated block id=" << allocated.id
-                 << " at address 0x"
-                 << hex << allocated.start << dec << endl;
-
-            return;
-        }
+        // No suitable free block found
+        cout << "Allocation failed: Not enough memory\n";
+        return;
     }
 
-    // Allocation failure: no suitable free block found
-    cout << "Allocation failed: Not enough memory\n";
+    // Report allocation result
+    cout << "Allocated block id=" << allocated.id
+         << " at address 0x"
+         << hex << allocated.start << dec << endl;
 }
@@ -0,0 +1,286 @@
+#include "free_index.h"
+
+using namespace std;
+
+/*
+ * Constructs an empty free-block index.
+ */
+FreeIndex::FreeIndex()
+    : by_address(-1), by_size(-1), indexed(0), seed(2463534242u)
+{}
+
+/*
+ * Drops every indexed block and resets the node pool.
+ */
+void FreeIndex::clear()
+{
+    nodes.clear();
+    spare.clear();
+    by_address = -1;
+    by_size = -1;
+    indexed = 0;
+}
+
+/*
+ * Takes a node from the pool (recycling erased nodes first).
+ */
+int FreeIndex::new_node(size_t key1, size_t key2, BlockRef block)
+{
+    // xorshift32 priorities keep the treap balanced in expectation
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    Node n;
+    n.key1 = key1;
+    n.key2 = key2;
+    n.size = block->size;
+    n.max_size = block->size;
+    n.priority = seed;
+    n.left = -1;
+    n.right = -1;
+    n.block = block;
+
+    if (!spare.empty())
+    {
+        int t = spare.back();
+        spare.pop_back();
+        nodes[t] = n;
+        return t;
+    }
+
+    nodes.push_back(n);
+    return (int)nodes.size() - 1;
+}
+
+/*
+ * Recomputes the subtree maximum block size of node t.
+ */
+void FreeIndex::update(int t)
+{
+    size_t m = nodes[t].size;
+    if (nodes[t].left != -1 && nodes[nodes[t].left].max_size > m)
+        m = nodes[nodes[t].left].max_size;
+    if (nodes[t].right != -1 && nodes[nodes[t].right].max_size > m)
+        m = nodes[nodes[t].right].max_size;
+    nodes[t].max_size = m;
+}
+
+/*
+ * Returns true if node t orders strictly before the given key.
+ */
+bool FreeIndex::less(int t, size_t key1, size_t key2) const
+{
+    return nodes[t].key1 < key1 ||
+           (nodes[t].key1 == key1 && nodes[t].key2 < key2);
+}
+
+/*
+ * Splits tree t into keys < (key1, key2) and keys >= (key1, key2).
+ */
+void FreeIndex::split(int t, size_t key1, size_t key2, int &l, int &r)
+{
+    if (t == -1)
+    {
+        l = r = -1;
+        return;
+    }
+
+    if (less(t, key1, key2))
+    {
+        split(nodes[t].right, key1, key2, nodes[t].right, r);
+        l = t;
+    }
+    else
+    {
+        split(nodes[t].left, key1, key2, l, nodes[t].left);
+        r = t;
+    }
+    update(t);
+}
+
+/*
+ * Joins two trees where every key in l orders before every key in r.
+ */
+int FreeIndex::merge(int l, int r)
+{
+    if (l == -1)
+        return r;
+    if (r == -1)
+        return l;
+
+    if (nodes[l].priority > nodes[r].priority)
+    {
+        nodes[l].right = merge(nodes[l].right, r);
+        update(l);
+        return l;
+    }
+
+    nodes[r].left = merge(l, nodes[r].left);
+    update(r);
+    return r;
+}
+
+/*
+ * Inserts node n into the tree rooted at root; returns the new root.
+ */
+int FreeIndex::insert_node(int root, int n)
+{
+    int l, r;
+    split(root, nodes[n].key1, nodes[n].key2, l, r);
+    return merge(merge(l, n), r);
+}
+
+/*
+ * Removes the node with the given key; returns the new root.
+ */
+int FreeIndex::erase_node(int root, size_t key1, size_t key2)
+{
+    if (root == -1)
+        return -1;
+
+    if (nodes[root].key1 == key1 && nodes[root].key2 == key2)
+    {
+        int joined = merge(nodes[root].left, nodes[root].right);
+        spare.push_back(root);
+        return joined;
+    }
+
+    if (less(root, key1, key2))
+        nodes[root].right = erase_node(nodes[root].right, key1, key2);
+    else
+        nodes[root].left = erase_node(nodes[root].left, key1, key2);
+
+    update(root);
+    return root;
+}
+
+/*
+ * Finds the first node whose key is >= (key1, key2), or -1.
+ */
+int FreeIndex::lower_bound(int root, size_t key1, size_t key2) const
+{
+    int found = -1;
+    int t = root;
+
+    while (t != -1)
+    {
+        if (less(t, key1, key2))
+        {
+            t = nodes[t].right;
+        }
+        else
+        {
+            found = t;
+            t = nodes[t].left;
+        }
+    }
+
+    return found;
+}
+
+/*
+ * Indexes a free block in both trees.
+ */
+void FreeIndex::insert(BlockRef block)
+{
+    by_address = insert_node(by_address, new_node(block->start, 0, block));
+    by_size = insert_node(by_size, new_node(block->size, block->start, block));
+    indexed++;
+}
+
+/*
+ * Removes a free block from both trees.
+ * The block's start and size must still match the indexed values.
+ */
+void FreeIndex::erase(BlockRef block)
+{
+    by_address = erase_node(by_address, block->start, 0);
+    by_size = erase_node(by_size, block->size, block->start);
+    indexed--;
+}
+
+/*
+ * First Fit: walk down the address tree, preferring the left
+ * subtree whenever it contains a block that is large enough.
+ */
+bool FreeIndex::first_fit(size_t size, BlockRef &out) const
+{
+    int t = by_address;
+    if (t == -1 || nodes[t].max_size < size)
+        return false;
+
+    while (true)
+    {
+        int l = nodes[t].left;
+        if (l != -1 && nodes[l].max_size >= size)
+            t = l;
+        else if (nodes[t].size >= size)
+            break;
+        else
+            t = nodes[t].right;
+    }
+
+    out = nodes[t].block;
+    return true;
+}
+
+/*
+ * Next Fit: lowest-addressed block that fits among those starting
+ * at or above `address`. Subtrees whose largest block is too small
+ * are pruned, so only the boundary path and one descent are visited.
+ */
+int FreeIndex::first_fit_from(int t, size_t address, size_t size) const
+{
+    if (t == -1 || nodes[t].max_size < size)
+        return -1;
+
+    // Everything on the left lies below `address`
+    if (nodes[t].key1 < address)
+        return first_fit_from(nodes[t].right, address, size);
+
+    int found = first_fit_from(nodes[t].left, address, size);
+    if (found != -1)
+        return found;
+    if (nodes[t].size >= size)
+        return t;
+    return first_fit_from(nodes[t].right, address, size);
+}
+
+bool FreeIndex::first_fit_from(size_t address, size_t size,
+                               BlockRef &out) const
+{
+    int t = first_fit_from(by_address, address, size);
+    if (t == -1)
+        return false;
+
+    out = nodes[t].block;
+    return true;
+}
+
+/*
+ * Best Fit: smallest (size, start) key not below (size, 0).
+ */
+bool FreeIndex::best_fit(size_t size, BlockRef &out) const
+{
+    int t = lower_bound(by_size, size, 0);
+    if (t == -1)
+        return false;
+
+    out = nodes[t].block;
+    return true;
+}
+
+/*
+ * Worst Fit: find the largest size, then the lowest address
+ * holding a block of that size.
+ */
+bool FreeIndex::worst_fit(size_t size, BlockRef &out) const
+{
+    if (by_address == -1 || nodes[by_address].max_size < size)
+        return false;
+
+    int t = lower_bound(by_size, nodes[by_address].max_size, 0);
+    out = nodes[t].block;
+    return true;
+}
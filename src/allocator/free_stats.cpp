@@ -0,0 +1,60 @@
+#include "free_stats.h"
+
+using namespace std;
+
+const int FreeSpaceStats::BUCKETS;
+
+/*
+ * floor(log2(size)), via count-leading-zeros.
+ */
+int FreeSpaceStats::bucket(size_t size)
+{
+    return 63 - __builtin_clzll((unsigned long long)size);
+}
+
+/*
+ * Resets all totals and the histogram.
+ */
+void FreeSpaceStats::clear()
+{
+    free_bytes = 0;
+    free_blocks = 0;
+    for (int k = 0; k < BUCKETS; k++)
+    {
+        blocks[k] = 0;
+        bytes[k] = 0;
+    }
+    nonempty = 0;
+}
+
+/*
+ * Counts a new free block.
+ */
+void FreeSpaceStats::add(size_t size)
+{
+    if (size == 0)
+        return;
+
+    int k = bucket(size);
+    free_bytes += size;
+    free_blocks++;
+    blocks[k]++;
+    bytes[k] += size;
+    nonempty |= (uint64_t)1 << k;
+}
+
+/*
+ * Uncounts a free block that was allocated or merged away.
+ */
+void FreeSpaceStats::remove(size_t size)
+{
+    if (size == 0)
+        return;
+
+    int k = bucket(size);
+    free_bytes -= size;
+    free_blocks--;
+    bytes[k] -= size;
+    if (--blocks[k] == 0)
+        nonempty &= ~((uint64_t)1 << k);
+}
@@ -0,0 +1,173 @@
+#include <sstream>
+#include <string>
+#include "allocator.h"
+
+using namespace std;
+
+/*
+ * Checks one block against the end of the previous one.
+ * `prev_free` tells whether the previous block was free.
+ */
+static bool check_block(const Block &b, size_t cursor, bool prev_free,
+                        string &error)
+{
+    ostringstream out;
+
+    if (b.start != cursor)
+        out << "block at " << b.start << (b.start < cursor ? " overlaps"
+                                                           : " leaves a gap after")
+            << " the previous block (ends at " << cursor << ")";
+    else if (b.size == 0)
+        out << "empty block at " << b.start;
+    else if (b.free && prev_free)
+        out << "adjacent free blocks not coalesced at " << b.start;
+    else if (!b.free && b.requested > b.size)
+        out << "block " << b.id << " holds " << b.requested
+            << " requested bytes in " << b.size;
+    else
+        return true;
+
+    error = out.str();
+    return false;
+}
+
+/*
+ * Walks the blocks of the active backend in address order,
+ * re-deriving every counter the allocation paths maintain.
+ */
+bool Heap::check_invariants(string &error) const
+{
+    ostringstream out;
+    size_t cursor = 0, used = 0, requested = 0;
+    size_t free_bytes = 0, free_blocks = 0, allocated = 0, largest = 0;
+    bool prev_free = false, rover_ok = (rover == 0 || rover == total_memory);
+
+    if (backend == TAGGED_HEAP)
+    {
+        if (tag_heap.size() != total_memory)
+        {
+            out << "tag arena holds " << tag_heap.size() << " bytes, heap "
+                << total_memory;
+            error = out.str();
+            return false;
+        }
+
+        while (cursor < total_memory)
+        {
+            Block b = tag_heap.block_at(cursor);
+            if (!check_block(b, cursor, prev_free, error))
+                return false;
+            if (cursor + b.size > total_memory)
+            {
+                out << "block at " << cursor << " runs past the end of memory";
+                error = out.str();
+                return false;
+            }
+
+            if (b.free)
+            {
+                free_bytes += b.size;
+                free_blocks++;
+                if (b.size > largest)
+                    largest = b.size;
+            }
+            else
+            {
+                used += b.size;
+                requested += b.requested;
+                allocated++;
+                if (tag_heap.find(b.id) != b.start)
+                {
+                    out << "block " << b.id << " at " << b.start
+                        << " is not found by its ID";
+                    error = out.str();
+                    return false;
+                }
+            }
+
+            rover_ok = rover_ok || rover == b.start;
+            prev_free = b.free;
+            cursor += b.size;
+        }
+    }
+    else
+    {
+        for (auto it = memory_blocks.begin(); it != memory_blocks.end(); ++it)
+        {
+            const Block &b = *it;
+            if (!check_block(b, cursor, prev_free, error))
+                return false;
+
+            auto by_address = block_by_address.find(b.start);
+            if (by_address == block_by_address.end() || by_address->second != it)
+            {
+                out << "block at " << b.start << " is not found by its address";
+                error = out.str();
+                return false;
+            }
+
+            if (b.free)
+            {
+                free_bytes += b.size;
+                free_blocks++;
+                if (b.size > largest)
+                    largest = b.size;
+            }
+            else
+            {
+                used += b.size;
+                requested += b.requested;
+                allocated++;
+
+                auto by_id = block_by_id.find(b.id);
+                if (by_id == block_by_id.end() || by_id->second != it)
+                {
+                    out << "block " << b.id << " at " << b.start
+                        << " is not found by its ID";
+                    error = out.str();
+                    return false;
+                }
+            }
+
+            rover_ok = rover_ok || rover == b.start;
+            prev_free = b.free;
+            cursor += b.size;
+        }
+
+        size_t indexed = (index_family == TLSF_BINS) ? tlsf_index.count()
+                                                     : free_index.count();
+        if (indexed != free_blocks)
+            out << "free index holds " << indexed << " blocks, heap has "
+                << free_blocks;
+        else if (block_by_id.size() != allocated)
+            out << "ID map holds " << block_by_id.size()
+                << " blocks, heap has " << allocated << " allocated";
+        else if (block_by_address.size() != memory_blocks.size())
+            out << "address map holds " << block_by_address.size()
+                << " blocks, heap has " << memory_blocks.size();
+
+        error = out.str();
+        if (!error.empty())
+            return false;
+    }
+
+    const FreeSpaceStats &fs = free_stats();
+
+    if (cursor != total_memory)
+        out << "blocks cover " << cursor << " of " << total_memory << " bytes";
+    else if (used != used_bytes || requested != requested_bytes)
+        out << "used/requested counters are " << used_bytes << "/"
+            << requested_bytes << ", blocks hold " << used << "/" << requested;
+    else if (fs.free_bytes != free_bytes || fs.free_blocks != free_blocks)
+        out << "free-space totals are " << fs.free_bytes << " bytes in "
+            << fs.free_blocks << " blocks, heap has " << free_bytes
+            << " in " << free_blocks;
+    else if (largest_free() != largest)
+        out << "largest free block is reported as " << largest_free()
+            << " bytes, heap has " << largest;
+    else if (!rover_ok)
+        out << "next fit rover " << rover << " is not on a block boundary";
+
+    error = out.str();
+    return error.empty();
+}
@@ -0,0 +1,70 @@
+#include "allocator.h"
+#include <iostream>
+
+using namespace std;
+
+/*
+ * Allocates memory using the Next Fit strategy.
+ *
+ * Like First Fit, but the search resumes at the rover, the block
+ * boundary where the previous Next Fit allocation ended, instead of
+ * at address 0. The small leftover blocks that accumulate at the
+ * front of memory are therefore not searched again on every request.
+ * If nothing at or above the rover fits, the search wraps around to
+ * the start of memory.
+ *
+ * On the list backend the resumed search is a single descent of the
+ * address-ordered free index (O(log n)).
+ */
+bool Heap::place_next_fit(size_t size, Block &out)
+{
+    // Zero-byte requests are rejected: an empty block would share
+    // its address with a neighbour
+    if (size == 0)
+        return false;
+
+    // Block size including header, footer and size-class rounding
+    size_t need = block_size_for(size);
+
+    if (backend == TAGGED_HEAP)
+    {
+        if (!carve_tagged(tag_heap.next_fit(rover, need), need, size, out))
+            return false;
+    }
+    else
+    {
+        // Resume at the rover, wrapping to the start of memory
+        activate_free_index(NEXT_FIT);
+        FreeIndex::BlockRef it;
+        if (!free_index.first_fit_from(rover, need, it) &&
+            !free_index.first_fit(need, it))
+            return false;
+
+        out = *carve_block(it, need, size);
+    }
+
+    // The next search starts right after this block
+    rover = out.start + out.size;
+    if (rover >= total_memory)
+        rover = 0;
+    return true;
+}
+
+/*
+ * Next Fit front-end: places the request and reports the result.
+ */
+void Heap::malloc_next_fit(size_t size)
+{
+    Block allocated;
+    if (!place_block(NEXT_FIT, size, allocated))
+    {
+        // No suitable free block found
+        cout << "Allocation failed: Not enough memory\n";
+        return;
+    }
+
+    // Report allocation result
+    cout << "Allocated block id=" << allocated.id
+         << " at address 0x"
+         << hex << allocated.start << dec << endl;
+}
@@ -0,0 +1,162 @@
+#include "allocator.h"
+#include <iostream>
+
+using namespace std;
+
+/*
+ * Resizes an allocated block.
+ *
+ *  - Shrink: the tail is split off in place and merged with a free
+ *    successor if there is one (a tail below min_split with no free
+ *    successor stays in the block)
+ *  - Grow: if the following block is free and large enough, the
+ *    block is extended into it in place
+ *  - Otherwise a new block is placed with `type` while the old one
+ *    is still allocated, its contents (the requested bytes) are
+ *    copied, and the old block is freed
+ *
+ * The free indexes, address index and byte counters are kept in
+ * sync, and the Next Fit rover is kept on a block boundary.
+ */
+ReallocResult Heap::realloc(int id, size_t new_size, AllocatorType type)
+{
+    ReallocResult result;
+
+    auto found = block_by_id.find(id);
+    if (backend != LIST_HEAP || new_size == 0 || found == block_by_id.end() ||
+        arena_backed_by(id) != -1)
+        return result;
+
+    auto it = found->second;
+    auto next = it;
+    ++next;
+    bool next_free = (next != memory_blocks.end() && next->free);
+
+    size_t old_size = it->size;
+    size_t old_requested = it->requested;
+    size_t need = block_size_for(new_size);
+
+    if (need <= old_size)
+    {
+        // Shrink in place: give the tail back to the free space,
+        // unless it would be a sliver with nothing free to join
+        size_t tail = old_size - need;
+
+        if (tail > 0 && next_free)
+        {
+            it->size = need;
+            unindex_free(next);
+            block_by_address.erase(next->start);
+            next->start -= tail;
+            next->size += tail;
+            block_by_address[next->start] = next;
+            index_free(next);
+            settle_rover(next->start, next->size);
+        }
+        else if (tail > 0 && tail >= min_split)
+        {
+            it->size = need;
+
+            Block rem;
+            rem.start = it->start + need;
+            rem.size = tail;
+            rem.requested = 0;
+            rem.free = true;
+            rem.id = -1;
+
+            auto rem_it = memory_blocks.insert(next, rem);
+            block_by_address[rem.start] = rem_it;
+            index_free(rem_it);
+        }
+    }
+    else if (next_free && next->size >= need - old_size)
+    {
+        // Grow in place into the free successor, taking all of it
+        // if the rest would be below min_split
+        size_t grow = need - old_size;
+        if (next->size - grow < min_split)
+            grow = next->size;
+
+        unindex_free(next);
+        block_by_address.erase(next->start);
+
+        if (next->size == grow)
+        {
+            memory_blocks.erase(next);
+        }
+        else
+        {
+            next->start += grow;
+            next->size -= grow;
+            block_by_address[next->start] = next;
+            index_free(next);
+        }
+
+        it->size = old_size + grow;
+
+        // The rover may have pointed at the consumed part
+        if (it->start < rover && rover < it->start + it->size)
+            rover = it->start + it->size;
+    }
+    else
+    {
+        // Move: allocate elsewhere, copy, then free the old block
+        Block moved;
+        if (!place_block(type, new_size, moved))
+            return result;
+
+        release_block(it);
+
+        result.moved = true;
+        result.bytes_copied = old_requested;
+        result.block = moved;
+
+        reallocs++;
+        realloc_copied += old_requested;
+        result.ok = true;
+        return result;
+    }
+
+    used_bytes = used_bytes - old_size + it->size;
+    requested_bytes = requested_bytes - old_requested + new_size;
+    it->requested = new_size;
+
+    reallocs++;
+    reallocs_in_place++;
+    result.block = *it;
+    result.ok = true;
+    return result;
+}
+
+/*
+ * Realloc front-end: reports whether the block was resized in
+ * place or moved, and how many bytes the move copied.
+ */
+static void report_realloc(int id, size_t new_size, const ReallocResult &r)
+{
+    if (!r.ok)
+    {
+        cout << "Realloc of block " << id << " to " << new_size
+             << " bytes failed\n";
+        return;
+    }
+
+    if (r.moved)
+        cout << "Block " << id << " moved to id=" << r.block.id
+             << " at address 0x" << hex << r.block.start << dec
+             << " (" << r.bytes_copied << " bytes copied)\n";
+    else
+        cout << "Block " << id << " resized in place to "
+             << r.block.requested << " bytes\n";
+}
+
+void realloc_block(int id, size_t new_size, AllocatorType type)
+{
+    if (current_heap->backend != LIST_HEAP)
+    {
+        cout << "Realloc requires the list heap (init memory <size>)\n";
+        return;
+    }
+
+    report_realloc(id, new_size, current_heap->realloc(id, new_size, type));
+}
@@ -0,0 +1,346 @@
+#include "tag_heap.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+using namespace std;
+
+/*
+ * Boundary tag encoding helpers.
+ * The low bit holds the free flag, the remaining bits the block size.
+ */
+static inline size_t tag_size(size_t tag) { return tag >> 1; }
+static inline bool tag_free(size_t tag) { return (tag & 1) != 0; }
+
+const size_t TagHeap::NONE;
+const size_t TagHeap::WORD;
+const size_t TagHeap::MIN_BLOCK;
+
+/*
+ * Releases the arena and slot table.
+ */
+TagHeap::~TagHeap()
+{
+    free(arena);
+    free(slots);
+}
+
+/*
+ * Resets the arena to one free block spanning all of memory.
+ * calloc leaves the zero-filling to the host's lazily mapped pages,
+ * so only the two tags of the initial block are written and every
+ * slot starts empty.
+ */
+void TagHeap::init(size_t size)
+{
+    free(arena);
+    free(slots);
+    arena = nullptr;
+    slots = nullptr;
+    length = 0;
+    slot_count = 0;
+    free_space.clear();
+
+    if (size == 0)
+        return;
+
+    size_t count = size / MIN_BLOCK + 1;
+    arena = static_cast<unsigned char *>(calloc(size, 1));
+    slots = static_cast<Slot *>(calloc(count, sizeof(Slot)));
+    if (!arena || !slots)
+    {
+        free(arena);
+        free(slots);
+        arena = nullptr;
+        slots = nullptr;
+        throw bad_alloc();
+    }
+    length = size;
+    slot_count = count;
+
+    write_free(0, size);
+    free_space.add(size);
+}
+
+/*
+ * Reads / writes the tag word at `addr`.
+ */
+size_t TagHeap::load(size_t addr) const
+{
+    size_t word;
+    memcpy(&word, arena + addr, WORD);
+    return word;
+}
+
+void TagHeap::store(size_t addr, size_t word)
+{
+    memcpy(arena + addr, &word, WORD);
+}
+
+/*
+ * Writes matching header and footer tags for a free block.
+ * For a one-word block the header and footer share a word.
+ */
+void TagHeap::write_free(size_t start, size_t size)
+{
+    size_t tag = (size << 1) | 1;
+    store(start, tag);
+    store(start + size - WORD, tag);
+}
+
+/*
+ * Slot table lookup: probes from the home slot of `id` up to the
+ * first empty slot.
+ */
+const TagHeap::Slot *TagHeap::find_slot(int id) const
+{
+    if (id <= 0 || slot_count == 0)
+        return nullptr;
+
+    for (size_t i = (size_t)id % slot_count; slots[i].id != 0;
+         i = (i + 1) % slot_count)
+    {
+        if (slots[i].id == id)
+            return &slots[i];
+    }
+    return nullptr;
+}
+
+void TagHeap::insert_slot(int id, size_t start, size_t requested)
+{
+    size_t i = (size_t)id % slot_count;
+    while (slots[i].id != 0)
+        i = (i + 1) % slot_count;
+    slots[i] = Slot{id, start, requested};
+}
+
+/*
+ * Removes `id` and closes the hole by shifting back later entries of
+ * the probe run whose home slot is not between the hole and them,
+ * so lookups never need tombstones.
+ */
+void TagHeap::erase_slot(int id)
+{
+    const Slot *found = find_slot(id);
+    if (!found)
+        return;
+
+    size_t hole = (size_t)(found - slots);
+    for (size_t i = (hole + 1) % slot_count; slots[i].id != 0;
+         i = (i + 1) % slot_count)
+    {
+        size_t home = (size_t)slots[i].id % slot_count;
+        bool reachable = (hole <= i) ? (hole < home && home <= i)
+                                     : (hole < home || home <= i);
+        if (!reachable)
+        {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+    slots[hole] = Slot{0, 0, 0};
+}
+
+/*
+ * First Fit: the first free header large enough.
+ */
+size_t TagHeap::first_fit(size_t size) const
+{
+    for (size_t a = 0; a < length; a += tag_size(load(a)))
+    {
+        if (tag_free(load(a)) && tag_size(load(a)) >= size)
+            return a;
+    }
+    return NONE;
+}
+
+/*
+ * Best Fit: the smallest free block that fits (first on ties).
+ */
+size_t TagHeap::best_fit(size_t size) const
+{
+    size_t best = NONE;
+    for (size_t a = 0; a < length; a += tag_size(load(a)))
+    {
+        if (tag_free(load(a)) && tag_size(load(a)) >= size &&
+            (best == NONE || tag_size(load(a)) < tag_size(load(best))))
+            best = a;
+    }
+    return best;
+}
+
+/*
+ * Worst Fit: the largest free block that fits (first on ties).
+ */
+size_t TagHeap::worst_fit(size_t size) const
+{
+    size_t worst = NONE;
+    for (size_t a = 0; a < length; a += tag_size(load(a)))
+    {
+        if (tag_free(load(a)) && tag_size(load(a)) >= size &&
+            (worst == NONE || tag_size(load(a)) > tag_size(load(worst))))
+            worst = a;
+    }
+    return worst;
+}
+
+/*
+ * Next Fit: walks from the header at `from` to the end of the arena,
+ * then wraps around from address 0 up to `from`. The rover always
+ * sits on a block boundary (or past the end), so each block is
+ * visited once.
+ */
+size_t TagHeap::next_fit(size_t from, size_t size) const
+{
+    if (from > length)
+        from = length;
+
+    for (size_t a = from; a < length; a += tag_size(load(a)))
+    {
+        if (tag_free(load(a)) && tag_size(load(a)) >= size)
+            return a;
+    }
+    for (size_t a = 0; a < from; a += tag_size(load(a)))
+    {
+        if (tag_free(load(a)) && tag_size(load(a)) >= size)
+            return a;
+    }
+    return NONE;
+}
+
+/*
+ * The largest free block is in the top non-empty histogram bucket.
+ * If that bucket holds a single block, its byte total is the answer;
+ * otherwise the walk compares the bucket's blocks and stops once it
+ * has seen all of them.
+ */
+size_t TagHeap::largest_free() const
+{
+    uint64_t mask = free_space.nonempty_buckets();
+    if (mask == 0)
+        return 0;
+
+    int k = 63 - __builtin_clzll((unsigned long long)mask);
+    if (free_space.blocks[k] == 1)
+        return free_space.bytes[k];
+
+    size_t best = 0, seen = 0;
+    for (size_t a = 0; a < length && seen < free_space.blocks[k];
+         a += tag_size(load(a)))
+    {
+        size_t tag = load(a);
+        if (tag_free(tag) && FreeSpaceStats::bucket(tag_size(tag)) == k)
+        {
+            seen++;
+            if (tag_size(tag) > best)
+                best = tag_size(tag);
+        }
+    }
+    return best;
+}
+
+/*
+ * Splits the free block at `start` into an allocated block of
+ * `size` bytes followed by a free remainder (if any). The allocated
+ * block's footer records its ID.
+ */
+void TagHeap::allocate(size_t start, size_t size, int id, size_t requested)
+{
+    size_t original = tag_size(load(start));
+
+    store(start, size << 1);
+    store(start + size - WORD, (size_t)id << 1);
+    free_space.remove(original);
+    if (original > size)
+    {
+        write_free(start + size, original - size);
+        free_space.add(original - size);
+    }
+
+    insert_slot(id, start, requested);
+}
+
+/*
+ * Frees the block at `start`, merging with the following block
+ * (found via its header) and the preceding block (found via its footer).
+ */
+int TagHeap::release(size_t start, Block *merged)
+{
+    size_t size = tag_size(load(start));
+    int id = (int)(load(start + size - WORD) >> 1);
+    erase_slot(id);
+
+    // Coalesce with next block if free
+    size_t next = start + size;
+    if (next < length && tag_free(load(next)))
+    {
+        free_space.remove(tag_size(load(next)));
+        size += tag_size(load(next));
+    }
+
+    // Coalesce with previous block if free
+    if (start > 0 && tag_free(load(start - WORD)))
+    {
+        size_t prev_size = tag_size(load(start - WORD));
+        free_space.remove(prev_size);
+        start -= prev_size;
+        size += prev_size;
+    }
+
+    write_free(start, size);
+    free_space.add(size);
+
+    if (merged)
+        *merged = block_at(start);
+    return id;
+}
+
+/*
+ * Looks up a live block by ID.
+ */
+size_t TagHeap::find(int id) const
+{
+    const Slot *found = find_slot(id);
+    return found ? found->start : NONE;
+}
+
+/*
+ * Returns true if an allocated block begins exactly at `start`.
+ * Words between block boundaries may hold stale tags, so a header
+ * is only trusted if the ID in its footer maps back to `start`.
+ */
+bool TagHeap::allocated_at(size_t start) const
+{
+    if (start % WORD != 0 || start >= length)
+        return false;
+
+    size_t tag = load(start);
+    size_t size = tag_size(tag);
+    if (tag_free(tag) || size < MIN_BLOCK || size > length - start)
+        return false;
+
+    const Slot *found = find_slot((int)(load(start + size - WORD) >> 1));
+    return found && found->start == start;
+}
+
+/*
+ * Decodes the header at `start` (and, for an allocated block, the
+ * ID in its footer) into a Block record.
+ */
+Block TagHeap::block_at(size_t start) const
+{
+    size_t tag = load(start);
+
+    Block b;
+    b.start = start;
+    b.size = tag_size(tag);
+    b.free = tag_free(tag);
+    b.id = -1;
+    b.requested = 0;
+    if (!b.free)
+    {
+        b.id = (int)(load(start + b.size - WORD) >> 1);
+        b.requested = find_slot(b.id)->requested;
+    }
+    return b;
+}
@@ -0,0 +1,65 @@
+#include "allocator.h"
+#include <iostream>
+
+using namespace std;
+
+/*
+ * Allocates memory using Two-Level Segregated Fit (TLSF).
+ *
+ * Free blocks are kept in segregated lists binned by a power-of-two
+ * class and a linear subdivision of that class. The request is
+ * rounded up to the next bin boundary and the first non-empty bin
+ * at or above it is located with two bitmap find-first-set
+ * operations, so both allocation and free run in constant time
+ * regardless of how fragmented the heap is.
+ *
+ * The head block of the selected bin is split into an allocated
+ * block and a remaining free block, which is re-binned.
+ *
+ * TLSF is implemented for the list backend only.
+ */
+bool Heap::place_tlsf(size_t size, Block &out)
+{
+    // Zero-byte requests are rejected: an empty block would share
+    // its address with a neighbour
+    if (size == 0 || backend != LIST_HEAP)
+        return false;
+
+    // Block size including header, footer and size-class rounding
+    size_t need = block_size_for(size);
+
+    // Locate a good-fit bin through the bitmaps
+    activate_free_index(TLSF);
+    TlsfIndex::BlockRef it;
+    if (!tlsf_index.find(need, it))
+        return false;
+
+    // Allocate from the selected block, splitting off the remainder
+    out = *carve_block(it, need, size);
+    return true;
+}
+
+/*
+ * TLSF front-end: places the request and reports the result.
+ */
+void Heap::malloc_tlsf(size_t size)
+{
+    if (backend != LIST_HEAP)
+    {
+        cout << "TLSF requires the list heap (init memory <size>)\n";
+        return;
+    }
+
+    Block alloc;
+    if (!place_block(TLSF, size, alloc))
+    {
+        // No suitable bin populated
+        cout << "Allocation failed\n";
+        return;
+    }
+
+    // Report allocation result
+    cout << "Allocated block id=" << alloc.id
+         << " at address=0x"
+         << hex << alloc.start << dec << "\n";
+}
@@ -0,0 +1,196 @@
+#include "tlsf_index.h"
+
+using namespace std;
+
+const int TlsfIndex::SL_LOG2;
+const int TlsfIndex::SL_COUNT;
+const int TlsfIndex::FL_COUNT;
+
+/*
+ * Index of the most significant set bit (n must be non-zero).
+ */
+static inline int fls(size_t n)
+{
+    return 63 - __builtin_clzll((unsigned long long)n);
+}
+
+/*
+ * Index of the least significant set bit (n must be non-zero).
+ */
+static inline int ffs64(uint64_t n)
+{
+    return __builtin_ctzll(n);
+}
+
+/*
+ * Constructs an empty TLSF index.
+ */
+TlsfIndex::TlsfIndex()
+{
+    clear();
+}
+
+/*
+ * Empties every bin by clearing both bitmap levels; a bin head is
+ * only read while its bitmap bit is set.
+ */
+void TlsfIndex::clear()
+{
+    fl_bitmap = 0;
+    for (int fl = 0; fl < FL_COUNT; fl++)
+        sl_bitmap[fl] = 0;
+    indexed = 0;
+}
+
+/*
+ * Maps a block size to its (first level, second level) bin.
+ *
+ * Sizes below SL_COUNT fall in class 0, one bin per byte.
+ * Larger sizes use class fls(size) - SL_LOG2 + 1, subdivided by
+ * the SL_LOG2 bits following the leading one.
+ */
+void TlsfIndex::mapping(size_t size, int &fl, int &sl)
+{
+    if (size < (size_t)SL_COUNT)
+    {
+        fl = 0;
+        sl = (int)size;
+        return;
+    }
+
+    int f = fls(size);
+    sl = (int)(size >> (f - SL_LOG2)) - SL_COUNT;
+    fl = f - SL_LOG2 + 1;
+}
+
+/*
+ * Pushes a free block onto the head of its bin.
+ */
+void TlsfIndex::insert(BlockRef block)
+{
+    int fl, sl;
+    mapping(block->size, fl, sl);
+
+    BlockRef &head = bins[fl][sl];
+    block->bin_prev = block;
+    if (sl_bitmap[fl] & (1u << sl))
+    {
+        block->bin_next = head;
+        head->bin_prev = block;
+    }
+    else
+        block->bin_next = block;
+    head = block;
+    indexed++;
+
+    fl_bitmap |= (uint64_t)1 << fl;
+    sl_bitmap[fl] |= 1u << sl;
+}
+
+/*
+ * Unlinks a free block from its bin, clearing bitmap bits when
+ * the bin (and then the class) becomes empty.
+ */
+void TlsfIndex::erase(BlockRef block)
+{
+    int fl, sl;
+    mapping(block->size, fl, sl);
+
+    BlockRef prev = block->bin_prev, next = block->bin_next;
+    bool first = (prev == block), last = (next == block);
+    indexed--;
+
+    if (first && last)
+    {
+        sl_bitmap[fl] &= ~(1u << sl);
+        if (sl_bitmap[fl] == 0)
+            fl_bitmap &= ~((uint64_t)1 << fl);
+    }
+    else if (first)
+    {
+        bins[fl][sl] = next;
+        next->bin_prev = next;
+    }
+    else if (last)
+        prev->bin_next = prev;
+    else
+    {
+        prev->bin_next = next;
+        next->bin_prev = prev;
+    }
+}
+
+/*
+ * Good-fit search: round the request up to the next bin boundary,
+ * then locate the first non-empty bin at or above it using the
+ * second-level bitmap, falling back to the first-level bitmap.
+ */
+bool TlsfIndex::find(size_t size, BlockRef &out) const
+{
+    // Round up so every block in the selected bin is large enough
+    if (size >= (size_t)SL_COUNT)
+    {
+        size_t round = ((size_t)1 << (fls(size) - SL_LOG2)) - 1;
+        if (size > (size_t)-1 - round)
+            return false;
+        size += round;
+    }
+
+    int fl, sl;
+    mapping(size, fl, sl);
+
+    // Non-empty bins in the same class, at or above sl
+    uint32_t sl_map = sl_bitmap[fl] & (~0u << sl);
+    if (sl_map == 0)
+    {
+        // Otherwise, the next non-empty class above fl
+        if (fl + 1 >= FL_COUNT)
+            return false;
+
+        uint64_t fl_map = fl_bitmap & (~(uint64_t)0 << (fl + 1));
+        if (fl_map == 0)
+            return false;
+
+        fl = ffs64(fl_map);
+        sl_map = sl_bitmap[fl];
+    }
+
+    sl = ffs64(sl_map);
+    out = bins[fl][sl];
+    return true;
+}
+
+/*
+ * The largest block lives in the highest non-empty bin, found from
+ * the top set bit of each bitmap level; the bin spans a range of
+ * sizes, so its blocks are compared.
+ */
+size_t TlsfIndex::largest() const
+{
+    if (fl_bitmap == 0)
+        return 0;
+
+    int fl = fls(fl_bitmap);
+    int sl = fls(sl_bitmap[fl]);
+
+    size_t best = 0;
+    for (BlockRef block = bins[fl][sl];; block = block->bin_next)
+    {
+        if (block->size > best)
+            best = block->size;
+        if (block->bin_next == block)
+            break;
+    }
+    return best;
+}
+
+/*
+ * Counts populated bins across all classes.
+ */
+int TlsfIndex::bins_used() const
+{
+    int used = 0;
+    for (int fl = 0; fl < FL_COUNT; fl++)
+        used += __builtin_popcount(sl_bitmap[fl]);
+    return used;
+}
@@ -6,70 +6,55 @@ using namespace std;
 /*
  * Allocates memory using the Worst Fit strategy.
  *
- * The allocator scans all free memory blocks and selects the
- * largest available block that can satisfy the request.
+ * The allocator selects the largest available free block that can
+ * satisfy the request, preferring the lowest address on ties.
  * The intention is to leave large leftover blocks in memory,
  * potentially reducing the creation of many small unusable fragments.
+ * The largest block is read from the free index in O(log n).
  *
  * If the selected block is larger than the request, it is split
  * into an allocated block and a remaining free block.
+ *
+ * On the boundary-tag backend the implicit block list is scanned.
  */
-void malloc_worst_fit(size_t size)
+bool Heap::place_worst_fit(size_t size, Block &out)
 {
-    // Iterator pointing to the largest suitable free block
-    auto worst = memory_blocks.end();
-
-    // Track allocation attempt
-    alloc_requests++;
-
-    // Search for the largest free block that can satisfy the request
-    for (auto it = memory_blocks.begin(); it != memory_blocks.end(); ++it)
-    {
-        if (it->free && it->size >= size)
-        {
-            if (worst == memory_blocks.end() || it->size > worst->size)
-                worst = it;
-        }
-    }
+    // Zero-byte requests are rejected: an empty block would share
+    // its address with a neighbour
+    if (size == 0)
+        return false;
+
+    // Block size including header, footer and size-class rounding
+    size_t need = block_size_for(size);
+
+    // Boundary-tag heap: walk the implicit block list
+    if (backend == TAGGED_HEAP)
+        return carve_tagged(tag_heap.worst_fit(need), need, size, out);
+
+    // Find the largest free block that can satisfy the request
+    activate_free_index(WORST_FIT);
+    FreeIndex::BlockRef it;
+    if (!free_index.worst_fit(need, it))
+        return false;
+
+    // Allocate from the selected block, splitting off the remainder
+    out = *carve_block(it, need, size);
+    return true;
+}
 
-    // No suitable free block found
-    if (worst == memory_blocks.end())
+/*
+ * Worst Fit front-end: places the request and reports the result.
+ */
+void Heap::malloc_worst_fit(size_t size)
+{
+    Block alloc;
+    if (!place_block(WORST_FIT, size, alloc))
     {
+        // No suitable free block found
         cout << "Allocation failed\n";
         return;
     }
 
-    // Create allocated block
-    Block alloc;
-    alloc.start = worst->start;
-    alloc.size = size;
-    alloc.requested = size;
-    alloc.free = false;
-    alloc.id = next_block_id++;
-
-    // Update allocation success counter
-    alloc_success++;
-
-    // Calculate remaining free space after allocation
-    size_t remaining = worst->size - size;
-
-    // Replace selected free block with allocated block
-    worst = memory_blocks.erase(worst);
-    memory_blocks.insert(worst, alloc);
-
-    // Insert remaining free block if space remains
-    if (remaining > 0)
-    {
-        Block rem;
-        rem.start = alloc.start + size;
-        rem.size = remaining;
-        rem.requested = 0;
-        rem.free = true;
-        rem.id = -1;
-
-        memory_blocks.insert(worst, rem);
-    }
-
     // Report allocation result
     cout << "Allocated block id=" << alloc.id
          << " at address=0x"
@@ -0,0 +1,399 @@
+/*
+ * Allocator throughput and fragmentation stress benchmark.
+ *
+ * Build:  make bench
+ * Usage:  ./memsim_bench [options]
+ *   --ops N          operations per run (default 1000000)
+ *   --seed S         workload seed (default 1)
+ *   --heap BYTES     heap size per allocator (default 67108864)
+ *   --workload W     random | skewed | prodcons | all (default all)
+ *   --strategy A     first_fit | best_fit | worst_fit | next_fit |
+ *                    tlsf | buddy | all (default all)
+ *   --check K        verify heap invariants every K operations
+ *
+ * Each run drives one allocator with one seeded workload and reports
+ * ops/sec, malloc and free latency percentiles, failed allocations
+ * and the fragmentation at the end of the run.
+ */
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <deque>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include "allocator.h"
+#include "buddy.h"
+
+using namespace std;
+
+/*
+ * Workload shapes.
+ *  - WL_RANDOM:   uniform sizes, frees of random live objects
+ *  - WL_SKEWED:   most requests from a few small size classes,
+ *                 a few large ones, frees of random live objects
+ *  - WL_PRODCONS: bursts of allocations queued by a producer and
+ *                 freed oldest-first by a consumer (FIFO lifetimes)
+ */
+enum Workload { WL_RANDOM, WL_SKEWED, WL_PRODCONS };
+
+static const char *workload_name(Workload w)
+{
+    switch (w)
+    {
+    case WL_RANDOM: return "random";
+    case WL_SKEWED: return "skewed";
+    default:        return "prodcons";
+    }
+}
+
+/*
+ * Benchmark configuration from the command line.
+ */
+struct BenchConfig {
+    long ops = 1000000;
+    unsigned seed = 1;
+    size_t heap = (size_t)1 << 26;
+    long check_every = 0;   // 0 = no invariant checks
+};
+
+/*
+ * Sentinel address of a failed allocation.
+ */
+static const size_t NONE = (size_t)-1;
+
+/*
+ * Allocators driven by run(): a list Heap with one strategy and the
+ * buddy allocator, behind the same set of members.
+ *  allocate / release:  one operation (address or NONE)
+ *  check:               the allocator's invariant checker
+ *  free_bytes ...:      figures for the fragmentation columns
+ */
+struct HeapAllocator {
+    AllocatorType type;
+    Heap heap;
+
+    HeapAllocator(AllocatorType t, size_t size) : type(t) { heap.init(size); }
+
+    size_t allocate(size_t size)
+    {
+        Block b;
+        return heap.place(type, size, b) ? b.start : NONE;
+    }
+
+    void release(size_t address) { heap.release_address(address); }
+    bool check(string &error) const { return heap.check_invariants(error); }
+    size_t free_bytes() const { return heap.free_stats().free_bytes; }
+    size_t largest_free() const { return heap.largest_free(); }
+    size_t used_bytes() const { return heap.used_bytes; }
+    size_t requested_bytes() const { return heap.requested_bytes; }
+};
+
+struct BuddyBench {
+    BuddyAllocator buddy;
+
+    explicit BuddyBench(size_t size) : buddy(size, 16) { buddy.verbose = false; }
+
+    size_t allocate(size_t size) { return buddy.allocate(size); }
+    void release(size_t address) { buddy.free_block(address); }
+    bool check(string &error) const { return buddy.check_invariants(error); }
+    size_t free_bytes() const { return buddy.total_size - buddy.allocated_bytes; }
+    size_t largest_free() const { return buddy.largest_free(); }
+    size_t used_bytes() const { return buddy.allocated_bytes; }
+    size_t requested_bytes() const { return buddy.requested_bytes; }
+};
+
+/*
+ * Size classes favoured by the skewed workload.
+ */
+static const size_t SKEWED_CLASSES[] = { 16, 24, 32, 48, 64, 96, 128, 256 };
+
+/*
+ * Generates the next request size of a workload.
+ */
+static size_t draw_size(Workload w, mt19937_64 &rng)
+{
+    if (w == WL_RANDOM)
+        return 1 + rng() % 4096;
+
+    if (w == WL_SKEWED)
+    {
+        if (rng() % 100 < 95)
+        {
+            // Class k is picked with probability ~ 2^-(k+1)
+            int k = 0;
+            while (k < 7 && (rng() & 1))
+                k++;
+            return SKEWED_CLASSES[k];
+        }
+        return 1024 + rng() % 64512;
+    }
+
+    return 32 + rng() % 2017;
+}
+
+/*
+ * Value at fraction `p` of a sorted latency sample.
+ */
+static double percentile(const vector<uint32_t> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    size_t k = (size_t)(p * (sorted.size() - 1));
+    return sorted[k];
+}
+
+static double ns_since(chrono::steady_clock::time_point begin,
+                       chrono::steady_clock::time_point end)
+{
+    return chrono::duration<double, nano>(end - begin).count();
+}
+
+/*
+ * Runs one workload against one allocator and prints its row.
+ * Returns false if an invariant check failed.
+ */
+template <typename Alloc>
+static bool run(const string &name, Alloc &alloc, Workload w,
+                const BenchConfig &cfg)
+{
+    mt19937_64 rng(cfg.seed);
+
+    // Live objects: random-access for random/skewed, FIFO for prodcons
+    vector<pair<size_t, size_t>> live;   // (address, size)
+    deque<pair<size_t, size_t>> queue;
+    size_t live_bytes = 0;
+    size_t target = cfg.heap / 2;        // Live bytes the mix hovers around
+    long burst = 0;                      // Remaining ops of the current burst
+    bool producing = true;
+
+    vector<uint32_t> malloc_ns, free_ns;
+    malloc_ns.reserve(cfg.ops / 2 + 1);
+    free_ns.reserve(cfg.ops / 2 + 1);
+    long failed = 0;
+    double busy_ns = 0;
+
+    for (long i = 0; i < cfg.ops; i++)
+    {
+        size_t count = (w == WL_PRODCONS) ? queue.size() : live.size();
+        bool do_alloc;
+
+        if (w == WL_PRODCONS)
+        {
+            if (burst == 0)
+            {
+                producing = live_bytes < target ? (rng() % 100 < 60)
+                                                : (rng() % 100 < 40);
+                burst = 1 + rng() % 256;
+            }
+            burst--;
+            do_alloc = producing || count == 0;
+        }
+        else
+        {
+            int p = live_bytes < target ? 60 : 40;
+            do_alloc = count == 0 || (int)(rng() % 100) < p;
+        }
+
+        if (do_alloc)
+        {
+            size_t size = draw_size(w, rng);
+            auto begin = chrono::steady_clock::now();
+            size_t addr = alloc.allocate(size);
+            auto end = chrono::steady_clock::now();
+
+            double ns = ns_since(begin, end);
+            busy_ns += ns;
+            malloc_ns.push_back((uint32_t)min(ns, 4e9));
+
+            if (addr == NONE)
+            {
+                failed++;
+            }
+            else
+            {
+                live_bytes += size;
+                if (w == WL_PRODCONS)
+                    queue.push_back(make_pair(addr, size));
+                else
+                    live.push_back(make_pair(addr, size));
+            }
+        }
+        else
+        {
+            pair<size_t, size_t> victim;
+            if (w == WL_PRODCONS)
+            {
+                victim = queue.front();
+                queue.pop_front();
+            }
+            else
+            {
+                size_t k = rng() % live.size();
+                victim = live[k];
+                live[k] = live.back();
+                live.pop_back();
+            }
+
+            auto begin = chrono::steady_clock::now();
+            alloc.release(victim.first);
+            auto end = chrono::steady_clock::now();
+
+            double ns = ns_since(begin, end);
+            busy_ns += ns;
+            free_ns.push_back((uint32_t)min(ns, 4e9));
+            live_bytes -= victim.second;
+        }
+
+        if (cfg.check_every > 0 && (i + 1) % cfg.check_every == 0)
+        {
+            string error;
+            if (!alloc.check(error))
+            {
+                cout << name << " / " << workload_name(w)
+                     << ": invariant violated after op " << i + 1
+                     << ": " << error << "\n";
+                return false;
+            }
+        }
+    }
+
+    sort(malloc_ns.begin(), malloc_ns.end());
+    sort(free_ns.begin(), free_ns.end());
+
+    size_t free_bytes = alloc.free_bytes();
+    size_t used = alloc.used_bytes();
+    double external = free_bytes
+        ? (1.0 - (double)alloc.largest_free() / free_bytes) * 100 : 0;
+    double internal = used
+        ? 100.0 * (used - alloc.requested_bytes()) / used : 0;
+
+    cout << left << setw(11) << name << setw(10) << workload_name(w)
+         << right << fixed << setprecision(0)
+         << setw(12) << (busy_ns > 0 ? cfg.ops / (busy_ns / 1e9) : 0)
+         << setw(8) << percentile(malloc_ns, 0.50)
+         << setw(8) << percentile(malloc_ns, 0.99)
+         << setw(9) << percentile(malloc_ns, 0.999)
+         << setw(8) << percentile(free_ns, 0.50)
+         << setw(8) << percentile(free_ns, 0.99)
+         << setw(9) << percentile(free_ns, 0.999)
+         << setw(9) << failed
+         << setprecision(1)
+         << setw(8) << external << "%"
+         << setw(8) << internal << "%" << "\n";
+    cout.unsetf(ios::fixed);
+    return true;
+}
+
+static void usage()
+{
+    cout << "Usage: memsim_bench [--ops N] [--seed S] [--heap BYTES]\n"
+         << "                    [--workload random|skewed|prodcons|all]\n"
+         << "                    [--strategy first_fit|best_fit|worst_fit|"
+            "next_fit|tlsf|buddy|all]\n"
+         << "                    [--check K]\n";
+}
+
+int main(int argc, char **argv)
+{
+    BenchConfig cfg;
+    string workload = "all", strategy = "all";
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            usage();
+            return 1;
+        }
+        string value = argv[++i];
+
+        if (arg == "--ops")
+            cfg.ops = atol(value.c_str());
+        else if (arg == "--seed")
+            cfg.seed = (unsigned)strtoul(value.c_str(), nullptr, 10);
+        else if (arg == "--heap")
+            cfg.heap = strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--workload")
+            workload = value;
+        else if (arg == "--strategy")
+            strategy = value;
+        else if (arg == "--check")
+            cfg.check_every = atol(value.c_str());
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (cfg.ops < 1 || cfg.heap < 16 || cfg.check_every < 0)
+    {
+        usage();
+        return 1;
+    }
+
+    vector<Workload> workloads;
+    const Workload all_workloads[] = { WL_RANDOM, WL_SKEWED, WL_PRODCONS };
+    for (int k = 0; k < 3; k++)
+        if (workload == "all" || workload == workload_name(all_workloads[k]))
+            workloads.push_back(all_workloads[k]);
+
+    // Buddy memory must be a power of two
+    size_t buddy_heap = 16;
+    while (buddy_heap < cfg.heap)
+        buddy_heap <<= 1;
+
+    vector<string> names;
+    for (int t = 0; t < ALLOCATOR_TYPES; t++)
+        names.push_back(allocator_name((AllocatorType)t));
+    names.push_back("buddy");
+
+    vector<int> selected;   // Indexes into names; ALLOCATOR_TYPES = buddy
+    for (size_t k = 0; k < names.size(); k++)
+        if (strategy == "all" || strategy == names[k])
+            selected.push_back((int)k);
+
+    if (workloads.empty() || selected.empty())
+    {
+        usage();
+        return 1;
+    }
+
+    cout << cfg.ops << " ops per run, seed " << cfg.seed << ", "
+         << cfg.heap << "-byte heap";
+    if (cfg.check_every)
+        cout << ", invariants checked every " << cfg.check_every << " ops";
+    cout << "\n";
+
+    cout << left << setw(11) << "strategy" << setw(10) << "workload"
+         << right << setw(12) << "ops/sec"
+         << setw(8) << "m p50" << setw(8) << "m p99" << setw(9) << "m p99.9"
+         << setw(8) << "f p50" << setw(8) << "f p99" << setw(9) << "f p99.9"
+         << setw(9) << "failed" << setw(9) << "ext" << setw(9) << "int"
+         << "\n";
+
+    bool ok = true;
+    for (size_t k = 0; k < selected.size(); k++)
+    {
+        for (size_t j = 0; j < workloads.size(); j++)
+        {
+            int t = selected[k];
+            if (t == ALLOCATOR_TYPES)
+            {
+                BuddyBench alloc(buddy_heap);
+                ok = run(names[t], alloc, workloads[j], cfg) && ok;
+            }
+            else
+            {
+                HeapAllocator alloc((AllocatorType)t, cfg.heap);
+                ok = run(names[t], alloc, workloads[j], cfg) && ok;
+            }
+        }
+    }
+
+    return ok ? 0 : 1;
+}
@@ -1,39 +1,134 @@
 #include "buddy.h"
 #include <iostream>
-#include <cmath>
 #include <algorithm>
+#include <sstream>
+#include <cassert>
 
 using namespace std;
 
+const size_t BuddyAllocator::NONE;
+const int BuddyAllocator::MAX_ORDERS;
+const uint8_t BuddyAllocator::NOT_ALLOCATED;
+
 /*
- * Computes the smallest power of two greater than or equal to n.
+ * Computes ceil(log2(n)) with a single count-leading-zeros.
  * Buddy allocation requires block sizes to be powers of two.
  */
-static size_t next_power_of_two(size_t n)
+static int ceil_log2(size_t n)
 {
-    size_t p = 1;
-    while (p < n)
-        p <<= 1;
-    return p;
+    return n <= 1 ? 0 : 64 - __builtin_clzll((unsigned long long)(n - 1));
 }
 
 /*
  * Constructs a Buddy Allocator.
  *
- * @param total  Total managed memory size (must be power of two)
- * @param minb   Minimum allocatable block size
+ * @param total  Total managed memory size (power of two)
+ * @param minb   Minimum allocatable block size (power of two, <= total)
  *
  * Initializes the allocator with a single free block covering
  * the entire memory region.
  */
 BuddyAllocator::BuddyAllocator(size_t total, size_t minb)
-    : total_size(total), min_block(minb)
+    : total_size(total), min_block(minb), nonempty_orders(0)
 {
-    // Initialize free lists for each block size
-    free_lists.clear();
+    assert(total != 0 && (total & (total - 1)) == 0);
+    assert(minb != 0 && (minb & (minb - 1)) == 0 && minb <= total);
+
+    min_shift = ceil_log2(min_block);
+    max_order = ceil_log2(total_size) - min_shift;
+
+    size_t slots = total_size / min_block;
+
+    // Intrusive links, one per minimum-size slot
+    next_free.assign(slots, NONE);
+    prev_free.assign(slots, NONE);
+
+    // No block is allocated yet
+    alloc_order.assign(slots, NOT_ALLOCATED);
+    requested_at.assign(slots, 0);
+
+    // Empty free lists; one free bitmap per order, one bit per block
+    free_bits.clear();
+    for (int k = 0; k < MAX_ORDERS; k++)
+    {
+        free_lists[k] = NONE;
+        if (k <= max_order)
+            free_bits.push_back(vector<uint64_t>(((slots >> k) + 63) / 64, 0));
+    }
 
     // Entire memory starts as one free block
-    free_lists[total_size].push_back(0);
+    push_free(0, max_order);
+}
+
+/*
+ * Returns the order serving a request of `size` bytes: the size is
+ * rounded up to a power of two and to at least min_block.
+ */
+int BuddyAllocator::order_for(size_t size) const
+{
+    int order = ceil_log2(size) - min_shift;
+    return order < 0 ? 0 : order;
+}
+
+/*
+ * Tests the free bit of the order-`order` block starting at addr.
+ */
+bool BuddyAllocator::is_free(size_t addr, int order) const
+{
+    size_t pos = addr >> (min_shift + order);
+    return (free_bits[order][pos / 64] >> (pos % 64)) & 1;
+}
+
+/*
+ * Sets or clears the free bit of the order-`order` block at addr.
+ */
+void BuddyAllocator::set_free_bit(size_t addr, int order, bool value)
+{
+    size_t pos = addr >> (min_shift + order);
+    if (value)
+        free_bits[order][pos / 64] |= (uint64_t)1 << (pos % 64);
+    else
+        free_bits[order][pos / 64] &= ~((uint64_t)1 << (pos % 64));
+}
+
+/*
+ * Links a free block at the head of its order's free list.
+ */
+void BuddyAllocator::push_free(size_t addr, int order)
+{
+    size_t slot = addr >> min_shift;
+    size_t head = free_lists[order];
+
+    next_free[slot] = head;
+    prev_free[slot] = NONE;
+    if (head != NONE)
+        prev_free[head >> min_shift] = addr;
+    free_lists[order] = addr;
+
+    nonempty_orders |= (uint64_t)1 << order;
+    set_free_bit(addr, order, true);
+}
+
+/*
+ * Unlinks a free block from its list in O(1) using its own links.
+ */
+void BuddyAllocator::remove_free(size_t addr, int order)
+{
+    size_t slot = addr >> min_shift;
+    size_t next = next_free[slot];
+    size_t prev = prev_free[slot];
+
+    if (prev != NONE)
+        next_free[prev >> min_shift] = next;
+    else
+        free_lists[order] = next;
+
+    if (next != NONE)
+        prev_free[next >> min_shift] = prev;
+
+    if (free_lists[order] == NONE)
+        nonempty_orders &= ~((uint64_t)1 << order);
+    set_free_bit(addr, order, false);
 }
 
 /*
@@ -48,78 +143,127 @@ BuddyAllocator::BuddyAllocator(size_t total, size_t minb)
  */
 size_t BuddyAllocator::allocate(size_t size)
 {
-    // Round request to a power of two and enforce minimum block size
-    size = next_power_of_two(size);
-    if (size < min_block)
-        size = min_block;
+    alloc_requests++;
 
-    size_t current = size;
+    // Round request to a power of two and enforce minimum block size
+    int order = (size > total_size) ? max_order + 1 : order_for(size);
 
-    // Find the smallest available block size >= requested size
-    while (free_lists[current].empty())
+    // Smallest non-empty order >= requested order, in one instruction
+    uint64_t usable = (order > max_order) ? 0
+                    : nonempty_orders & (~(uint64_t)0 << order);
+    if (usable == 0)
     {
-        current <<= 1;
-        if (current > total_size)
-        {
+        alloc_failures++;
+        if (verbose)
             cout << "Buddy allocation failed\n";
-            return (size_t)-1;
-        }
+        return (size_t)-1;
     }
+    int current = __builtin_ctzll(usable);
 
-    // Remove a free block of the selected size
-    size_t addr = free_lists[current].back();
-    free_lists[current].pop_back();
+    // Remove a free block of the selected order
+    size_t addr = free_lists[current];
+    remove_free(addr, current);
 
     // Recursively split blocks until desired size is reached
-    while (current > size)
+    while (current > order)
     {
-        current >>= 1;
-        free_lists[current].push_back(addr + current);
+        current--;
+        push_free(addr + (min_block << current), current);
     }
 
-    cout << "Buddy allocated block at 0x"
-         << hex << addr << dec
-         << " size " << size << endl;
+    // Record the block's order so it can be freed by address alone
+    alloc_order[addr >> min_shift] = (uint8_t)order;
+    requested_at[addr >> min_shift] = size;
+    allocated_bytes += min_block << order;
+    requested_bytes += size;
+    live_blocks++;
+
+    if (verbose)
+        cout << "Buddy allocated block at 0x"
+             << hex << addr << dec
+             << " size " << (min_block << order) << endl;
 
     return addr;
 }
 
 /*
- * Frees a previously allocated buddy block.
+ * Frees a previously allocated buddy block, looking up its order
+ * in the allocation map.
  *
  * Attempts to recursively coalesce the block with its buddy
  * using XOR-based address computation.
  *
  * @param addr  Starting address of the block to free
- * @param size  Size of the block being freed
+ * @return true if a live block started at addr and was freed
  */
-void BuddyAllocator::free_block(size_t addr, size_t size)
+bool BuddyAllocator::free_block(size_t addr)
 {
-    // Normalize size to power of two
-    size = next_power_of_two(size);
-    size_t buddy;
+    // Reject addresses that do not start a live allocation (O(1))
+    if (addr >= total_size || (addr & (min_block - 1)) ||
+        alloc_order[addr >> min_shift] == NOT_ALLOCATED)
+    {
+        rejected_frees++;
+        if (verbose)
+            cout << "Invalid or double buddy free at 0x"
+                 << hex << addr << dec << endl;
+        return false;
+    }
+
+    size_t slot = addr >> min_shift;
+    int order = alloc_order[slot];
+    size_t freed = min_block << order;
+
+    alloc_order[slot] = NOT_ALLOCATED;
+    allocated_bytes -= freed;
+    requested_bytes -= requested_at[slot];
+    live_blocks--;
 
     // Attempt buddy coalescing until maximum block size is reached
-    while (size < total_size)
+    while (order < max_order)
     {
         // Buddy address is computed using XOR
-        buddy = addr ^ size;
-
-        auto &list = free_lists[size];
-        auto it = find(list.begin(), list.end(), buddy);
+        size_t buddy = addr ^ (min_block << order);
 
-        // If buddy is not free, coalescing stops
-        if (it == list.end())
+        // If buddy is not free, coalescing stops (one bitmap test)
+        if (!is_free(buddy, order))
             break;
 
-        // Remove buddy from free list and merge blocks
-        list.erase(it);
+        // Unlink buddy from its free list and merge blocks
+        remove_free(buddy, order);
         addr = min(addr, buddy);
-        size <<= 1;
+        order++;
     }
 
     // Insert the merged block back into the appropriate free list
-    free_lists[size].push_back(addr);
+    push_free(addr, order);
+
+    if (verbose)
+        cout << "Buddy freed block of size " << freed << endl;
+    return true;
+}
+
+/*
+ * Frees a block whose size the caller also supplies.
+ * The size must round to the recorded order of the block.
+ *
+ * @param addr  Starting address of the block to free
+ * @param size  Size of the block being freed
+ */
+bool BuddyAllocator::free_block(size_t addr, size_t size)
+{
+    if (addr < total_size && !(addr & (min_block - 1)) &&
+        alloc_order[addr >> min_shift] != NOT_ALLOCATED &&
+        alloc_order[addr >> min_shift] != order_for(size))
+    {
+        rejected_frees++;
+        if (verbose)
+            cout << "Buddy free size mismatch at 0x" << hex << addr << dec
+                 << ": block size is "
+                 << (min_block << alloc_order[addr >> min_shift]) << endl;
+        return false;
+    }
+
+    return free_block(addr);
 }
 
 /*
@@ -130,11 +274,158 @@ void BuddyAllocator::free_block(size_t addr, size_t size)
 void BuddyAllocator::dump()
 {
     cout << "\n--- Buddy Free Lists ---\n";
-    for (auto &p : free_lists)
+    for (int k = 0; k <= max_order; k++)
     {
-        cout << "Size " << p.first << ": ";
-        for (auto a : p.second)
+        cout << "Size " << (min_block << k) << ": ";
+        for (size_t a = free_lists[k]; a != NONE; a = next_free[a >> min_shift])
             cout << "0x" << hex << a << " ";
         cout << dec << endl;
     }
 }
+
+/*
+ * Prints allocation statistics for the buddy allocator.
+ *
+ * Internal fragmentation is the rounding waste inside allocated
+ * blocks; external fragmentation compares the largest free block
+ * (the highest non-empty order) with all free memory.
+ */
+void BuddyAllocator::stats()
+{
+    size_t free_mem = total_size - allocated_bytes;
+    size_t largest = largest_free();
+
+    double internal_frag = allocated_bytes == 0 ? 0 :
+        (double)(allocated_bytes - requested_bytes) / allocated_bytes * 100;
+    double external_frag = free_mem == 0 ? 0 :
+        (1.0 - (double)largest / free_mem) * 100;
+
+    cout << "\n--- Buddy Statistics ---\n";
+    cout << "Total memory: " << total_size << "\n";
+    cout << "Allocated bytes: " << allocated_bytes
+         << " in " << live_blocks << " blocks\n";
+    cout << "Requested bytes: " << requested_bytes << "\n";
+    cout << "Free bytes: " << free_mem << "\n";
+    cout << "Internal fragmentation: "
+         << (allocated_bytes - requested_bytes) << " bytes ("
+         << internal_frag << "%)\n";
+    cout << "External fragmentation: " << external_frag << "%\n";
+    cout << "Allocation success rate: "
+         << (alloc_requests - alloc_failures) << "/" << alloc_requests << "\n";
+    cout << "Rejected frees: " << rejected_frees << "\n";
+}
+
+/*
+ * Walks memory block by block using the allocation map and the free
+ * bitmaps, then cross-checks the free lists against the blocks seen.
+ */
+bool BuddyAllocator::check_invariants(string &error) const
+{
+    ostringstream out;
+    auto fail = [&]() {
+        error = out.str();
+        return false;
+    };
+
+    vector<size_t> free_seen(max_order + 1, 0);
+    size_t used = 0, requested = 0;
+    int blocks = 0;
+
+    for (size_t addr = 0; addr < total_size; )
+    {
+        size_t slot = addr >> min_shift;
+        bool allocated = alloc_order[slot] != NOT_ALLOCATED;
+        int order = allocated ? alloc_order[slot] : -1;
+
+        if (allocated)
+        {
+            used += min_block << order;
+            requested += requested_at[slot];
+            blocks++;
+        }
+
+        // A block may be free at exactly one order, and only if not allocated
+        for (int k = 0; k <= max_order; k++)
+        {
+            if ((addr & ((min_block << k) - 1)) || !is_free(addr, k))
+                continue;
+            if (order >= 0)
+            {
+                out << "block at 0x" << hex << addr << dec << " is "
+                    << (allocated ? "allocated" : "free at another order")
+                    << " and free at order " << k;
+                return fail();
+            }
+            order = k;
+            free_seen[k]++;
+
+            size_t buddy = addr ^ (min_block << k);
+            if (k < max_order && is_free(buddy, k))
+            {
+                out << "free buddies at 0x" << hex << min(addr, buddy)
+                    << dec << " not coalesced (order " << k << ")";
+                return fail();
+            }
+        }
+
+        if (order < 0)
+        {
+            out << "address 0x" << hex << addr << dec
+                << " is neither allocated nor free";
+            return fail();
+        }
+        if (addr & ((min_block << order) - 1))
+        {
+            out << "block at 0x" << hex << addr << dec
+                << " is not aligned to its size " << (min_block << order);
+            return fail();
+        }
+        addr += min_block << order;
+    }
+
+    // Every free-list entry must be one of the free blocks walked
+    for (int k = 0; k <= max_order; k++)
+    {
+        size_t length = 0;
+        size_t limit = total_size / min_block;
+        for (size_t a = free_lists[k]; a != NONE && length <= limit;
+             a = next_free[a >> min_shift])
+        {
+            if (!is_free(a, k))
+            {
+                out << "free list " << k << " holds 0x" << hex << a << dec
+                    << ", which is not marked free";
+                return fail();
+            }
+            length++;
+        }
+
+        if (length != free_seen[k])
+        {
+            out << "free list " << k << " holds " << length
+                << " blocks, memory has " << free_seen[k];
+            return fail();
+        }
+        if ((free_lists[k] != NONE) != (bool)((nonempty_orders >> k) & 1))
+        {
+            out << "non-empty mask disagrees with free list " << k;
+            return fail();
+        }
+    }
+
+    if (used != allocated_bytes || requested != requested_bytes)
+    {
+        out << "allocated/requested counters are " << allocated_bytes << "/"
+            << requested_bytes << ", blocks hold " << used << "/" << requested;
+        return fail();
+    }
+    if (blocks != live_blocks)
+    {
+        out << "live block counter is " << live_blocks << ", memory has "
+            << blocks;
+        return fail();
+    }
+
+    error.clear();
+    return true;
+}
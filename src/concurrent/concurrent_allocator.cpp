@@ -0,0 +1,197 @@
+#include "concurrent.h"
+#include <chrono>
+
+using namespace std;
+
+const size_t ConcurrentAllocator::NONE;
+
+/*
+ * Constructs the front-end and its size-class tables.
+ *
+ * @param b          Central heap backend
+ * @param heap_size  Central heap size (power of two for buddy)
+ * @param cache      Enable per-thread caches
+ */
+ConcurrentAllocator::ConcurrentAllocator(CentralBackend b, size_t heap_size,
+                                         bool cache)
+    : backend(b), use_cache(cache),
+      buddy(b == CENTRAL_BUDDY ? heap_size : 16, 16)
+{
+    buddy.verbose = false;
+    if (backend == CENTRAL_LIST)
+        heap.init(heap_size);
+
+    // 16-byte steps up to 128, then four classes per power of two
+    int c = 0;
+    for (size_t s = 16; s <= 128; s += 16)
+        class_size[c++] = s;
+    for (size_t base = 128; c < SIZE_CLASSES; base <<= 1)
+    {
+        for (int i = 1; i <= 4 && c < SIZE_CLASSES; i++)
+            class_size[c++] = base + i * (base / 4);
+    }
+
+    // Direct lookup table from 16-byte granule to class
+    c = 0;
+    for (size_t g = 0; g <= MAX_SMALL_SIZE / 16; g++)
+    {
+        while (class_size[c] < g * 16)
+            c++;
+        class_of[g] = (uint8_t)c;
+    }
+}
+
+/*
+ * Takes the central lock, recording whether it was contended
+ * and how long the thread waited for it.
+ */
+void ConcurrentAllocator::lock()
+{
+    if (central.try_lock())
+    {
+        lock_acquisitions++;
+        return;
+    }
+
+    auto begin = chrono::steady_clock::now();
+    central.lock();
+    auto end = chrono::steady_clock::now();
+
+    lock_acquisitions++;
+    contended++;
+    wait_ns += chrono::duration_cast<chrono::nanoseconds>(end - begin).count();
+}
+
+/*
+ * Allocates from the central heap (caller holds the lock).
+ */
+size_t ConcurrentAllocator::central_alloc(size_t size)
+{
+    if (backend == CENTRAL_BUDDY)
+        return buddy.allocate(size);
+
+    Block b;
+    return heap.place_first_fit(size, b) ? b.start : NONE;
+}
+
+/*
+ * Frees to the central heap (caller holds the lock).
+ */
+void ConcurrentAllocator::central_free(size_t addr)
+{
+    if (backend == CENTRAL_BUDDY)
+        buddy.free_block(addr);
+    else
+        heap.release_address(addr);
+}
+
+/*
+ * Moves up to TRANSFER_BATCH objects of class `cls` from the
+ * central heap into the thread cache under one lock acquisition.
+ */
+void ConcurrentAllocator::refill(ThreadCache &cache, int cls)
+{
+    lock();
+    for (int i = 0; i < TRANSFER_BATCH; i++)
+    {
+        size_t addr = central_alloc(class_size[cls]);
+        if (addr == NONE)
+            break;
+        cache.lists[cls].push_back(addr);
+    }
+    central.unlock();
+}
+
+/*
+ * Returns `count` cached objects from the bottom of a list (the
+ * least recently freed) to the central heap under one lock.
+ */
+void ConcurrentAllocator::release_batch(vector<size_t> &list, size_t count)
+{
+    lock();
+    for (size_t i = 0; i < count; i++)
+        central_free(list[i]);
+    central.unlock();
+
+    list.erase(list.begin(), list.begin() + count);
+}
+
+/*
+ * Allocates from the thread cache when possible.
+ *
+ * Small requests pop the cache list of their size class, refilling
+ * it in a batch on a miss. Large requests, and all requests when
+ * caching is disabled, lock the central heap directly.
+ */
+size_t ConcurrentAllocator::allocate(ThreadCache &cache, size_t size)
+{
+    if (size == 0)
+        return NONE;
+
+    if (!use_cache || size > MAX_SMALL_SIZE)
+    {
+        lock();
+        size_t addr = central_alloc(size);
+        central.unlock();
+
+        if (addr == NONE)
+            cache.failures++;
+        return addr;
+    }
+
+    int cls = class_of[(size + 15) / 16];
+    vector<size_t> &list = cache.lists[cls];
+
+    if (list.empty())
+    {
+        cache.misses++;
+        refill(cache, cls);
+        if (list.empty())
+        {
+            cache.failures++;
+            return NONE;
+        }
+    }
+    else
+    {
+        cache.hits++;
+    }
+
+    size_t addr = list.back();
+    list.pop_back();
+    return addr;
+}
+
+/*
+ * Pushes a small object onto its class list, flushing a batch to
+ * the central heap when the list grows beyond 2 * TRANSFER_BATCH.
+ */
+void ConcurrentAllocator::deallocate(ThreadCache &cache, size_t addr,
+                                     size_t size)
+{
+    if (!use_cache || size > MAX_SMALL_SIZE)
+    {
+        lock();
+        central_free(addr);
+        central.unlock();
+        return;
+    }
+
+    vector<size_t> &list = cache.lists[class_of[(size + 15) / 16]];
+    list.push_back(addr);
+
+    if (list.size() > (size_t)(2 * TRANSFER_BATCH))
+        release_batch(list, TRANSFER_BATCH);
+}
+
+/*
+ * Empties every class list of the cache into the central heap.
+ */
+void ConcurrentAllocator::flush(ThreadCache &cache)
+{
+    for (int c = 0; c < SIZE_CLASSES; c++)
+    {
+        if (!cache.lists[c].empty())
+            release_batch(cache.lists[c], cache.lists[c].size());
+    }
+}
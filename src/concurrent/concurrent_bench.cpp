@@ -0,0 +1,158 @@
+#include "concurrent.h"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <random>
+#include <chrono>
+
+using namespace std;
+
+/*
+ * Central heap size used by the benchmark.
+ */
+static const size_t BENCH_HEAP = (size_t)1 << 25;
+
+/*
+ * Live objects each worker keeps at most.
+ */
+static const size_t MAX_LIVE = 1024;
+
+/*
+ * Per-thread results gathered after the run.
+ */
+struct WorkerResult {
+    long hits = 0;
+    long misses = 0;
+    long failures = 0;
+};
+
+/*
+ * Draws a request size: mostly small objects, some medium ones
+ * and an occasional large one that bypasses the thread cache.
+ */
+static size_t draw_size(mt19937 &rng)
+{
+    int p = rng() % 100;
+    if (p < 80)
+        return 8 + rng() % 249;
+    if (p < 99)
+        return 257 + rng() % 1792;
+    return 4096 + rng() % 12289;
+}
+
+/*
+ * One worker thread: a random mix of allocations and frees over a
+ * bounded set of live objects, all freed again at the end.
+ */
+static void worker(ConcurrentAllocator *alloc, int id, int ops,
+                   WorkerResult *result)
+{
+    ThreadCache cache;
+    mt19937 rng(1234 + id);
+
+    vector<pair<size_t, size_t>> live;   // (address, size)
+    live.reserve(MAX_LIVE);
+
+    for (int i = 0; i < ops; i++)
+    {
+        bool do_alloc = live.empty() ||
+                        (live.size() < MAX_LIVE && rng() % 100 < 55);
+
+        if (do_alloc)
+        {
+            size_t size = draw_size(rng);
+            size_t addr = alloc->allocate(cache, size);
+            if (addr != ConcurrentAllocator::NONE)
+                live.push_back(make_pair(addr, size));
+        }
+        else
+        {
+            size_t k = rng() % live.size();
+            alloc->deallocate(cache, live[k].first, live[k].second);
+            live[k] = live.back();
+            live.pop_back();
+        }
+    }
+
+    for (size_t k = 0; k < live.size(); k++)
+        alloc->deallocate(cache, live[k].first, live[k].second);
+    alloc->flush(cache);
+
+    result->hits = cache.hits;
+    result->misses = cache.misses;
+    result->failures = cache.failures;
+}
+
+/*
+ * Runs every thread count with and without thread caches and
+ * prints one table row per run.
+ */
+void run_concurrent_benchmark(CentralBackend backend, int max_threads,
+                              int ops_per_thread)
+{
+    cout << "Central heap: "
+         << (backend == CENTRAL_BUDDY ? "buddy" : "list (first fit)")
+         << ", " << BENCH_HEAP << " bytes, "
+         << ops_per_thread << " ops per thread\n";
+
+    cout << setfill(' ') << left << setw(9) << "threads" << setw(8) << "mode"
+         << right << setw(14) << "ops/sec" << setw(12) << "locks"
+         << setw(12) << "contended" << setw(12) << "wait ns"
+         << setw(10) << "hit rate" << setw(9) << "failed" << "\n";
+
+    vector<int> counts;
+    for (int t = 1; t < max_threads; t <<= 1)
+        counts.push_back(t);
+    counts.push_back(max_threads);
+
+    for (size_t c = 0; c < counts.size(); c++)
+    {
+        int threads = counts[c];
+
+        for (int mode = 0; mode < 2; mode++)
+        {
+            bool cached = (mode == 0);
+            ConcurrentAllocator alloc(backend, BENCH_HEAP, cached);
+            vector<WorkerResult> results(threads);
+            vector<thread> pool;
+
+            auto begin = chrono::steady_clock::now();
+            for (int i = 0; i < threads; i++)
+                pool.push_back(thread(worker, &alloc, i, ops_per_thread,
+                                      &results[i]));
+            for (int i = 0; i < threads; i++)
+                pool[i].join();
+            auto end = chrono::steady_clock::now();
+
+            double seconds = chrono::duration<double>(end - begin).count();
+            long hits = 0, misses = 0, failures = 0;
+            for (int i = 0; i < threads; i++)
+            {
+                hits += results[i].hits;
+                misses += results[i].misses;
+                failures += results[i].failures;
+            }
+
+            double ops = (double)threads * ops_per_thread;
+            double contended = alloc.lock_acquisitions
+                ? 100.0 * alloc.contended / alloc.lock_acquisitions : 0;
+            double avg_wait = alloc.contended
+                ? alloc.wait_ns / alloc.contended : 0;
+            double hit_rate = (hits + misses)
+                ? 100.0 * hits / (hits + misses) : 0;
+
+            cout << left << setw(9) << threads
+                 << setw(8) << (cached ? "cached" : "direct")
+                 << right << fixed << setprecision(0)
+                 << setw(14) << (seconds > 0 ? ops / seconds : 0)
+                 << setw(12) << alloc.lock_acquisitions
+                 << setprecision(1)
+                 << setw(11) << contended << "%"
+                 << setprecision(0) << setw(12) << avg_wait
+                 << setprecision(1) << setw(9) << hit_rate << "%"
+                 << setw(9) << failures << "\n";
+            cout.unsetf(ios::fixed);
+            cout << setprecision(6);
+        }
+    }
+}
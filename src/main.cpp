@@ -2,11 +2,17 @@
 #include <list>
 #include <iomanip>
 #include <string>
+#include <sstream>
+#include <map>
 
 #include "common.h"
 #include "cache.h"
 #include "vm.h"
 #include "buddy.h"
+#include "slab.h"
+#include "concurrent.h"
+#include "sim_malloc.h"
+#include "trace.h"
 #include "allocator.h"
 
 using namespace std;
@@ -24,6 +30,7 @@ int l3_size = 1024, l3_assoc = 4;
  * - CacheSystem models the multilevel cache hierarchy
  * - VirtualMemory models paging and address translation
  * - BuddyAllocator models power-of-two memory allocation
+ * - SlabAllocator carves buddy blocks into fixed-size object caches
  */
 CacheSystem cache(l1_size, l1_assoc,
                   l2_size, l2_assoc,
@@ -31,6 +38,7 @@ CacheSystem cache(l1_size, l1_assoc,
 
 VirtualMemory vm(8, 256, CLOCK_REPL);
 BuddyAllocator buddy(1024, 16);
+SlabAllocator slabs(&buddy);
 
 /*
  * Global simulator state flags and counters.
@@ -39,6 +47,13 @@ bool use_buddy = false;
 int total_memory_accesses = 0;
 AllocatorType current_allocator = FIRST_FIT;
 
+/*
+ * Named simulated heaps. The allocator commands operate on the
+ * current one; "main" always exists.
+ */
+map<string, Heap> heaps;
+string current_heap_name = "main";
+
 /*
  * Entry point of the memory management simulator.
  *
@@ -50,6 +65,8 @@ int main()
 {
     string command;
 
+    current_heap = &heaps[current_heap_name];
+
     cout << "Memory Simulator Started\n";
 
     // Main command-processing loop
@@ -60,14 +77,38 @@ int main()
 
         /*
          * Initialize physical memory.
-         * Usage: init memory <size>
+         * Usage: init memory <size>   (linked block list)
+         *        init tagged <size>   (contiguous boundary-tag heap)
+         *        init buddy <size> <min_block>
          */
         if (command == "init")
         {
-            string temp;
+            string backend;
             size_t size;
-            cin >> temp >> size;
-            init_memory(size);
+            cin >> backend >> size;
+
+            if (backend == "buddy")
+            {
+                size_t min_block;
+                cin >> min_block;
+
+                // Both sizes must be powers of two
+                if (size == 0 || min_block == 0 || min_block > size ||
+                    (size & (size - 1)) || (min_block & (min_block - 1)))
+                {
+                    cout << "Buddy sizes must be powers of two "
+                         << "with min_block <= size\n";
+                    continue;
+                }
+
+                buddy = BuddyAllocator(size, min_block);
+                slabs.reset();
+                cout << "Buddy memory initialized with size: " << size
+                     << " bytes, min block: " << min_block << " bytes\n";
+                continue;
+            }
+
+            init_memory(size, backend == "tagged" ? TAGGED_HEAP : LIST_HEAP);
         }
 
         /*
@@ -88,7 +129,7 @@ int main()
 
         /*
          * Allocate memory using the currently selected allocator.
-         * Supports First Fit, Best Fit, Worst Fit, or Buddy allocation.
+         * Supports First Fit, Best Fit, Worst Fit, TLSF, or Buddy allocation.
          */
         else if (command == "malloc")
         {
@@ -105,11 +146,39 @@ int main()
                     malloc_first_fit(size);
                 else if (current_allocator == BEST_FIT)
                     malloc_best_fit(size);
-                else
+                else if (current_allocator == WORST_FIT)
                     malloc_worst_fit(size);
+                else if (current_allocator == NEXT_FIT)
+                    malloc_next_fit(size);
+                else
+                    malloc_tlsf(size);
             }
         }
 
+        /*
+         * Allocate memory whose payload (after any block header)
+         * starts at an aligned address.
+         * Usage: malloc_aligned <size> <align>
+         */
+        else if (command == "malloc_aligned")
+        {
+            size_t size, align;
+            cin >> size >> align;
+            malloc_aligned(size, align);
+        }
+
+        /*
+         * Resize an allocated block; moves use the current strategy.
+         * Usage: realloc <id> <new_size>
+         */
+        else if (command == "realloc")
+        {
+            int id;
+            size_t size;
+            cin >> id >> size;
+            realloc_block(id, size, current_allocator);
+        }
+
         /*
          * Free memory by block ID or starting address.
          * Supports both:
@@ -138,8 +207,16 @@ int main()
          *
          * Examples:
          *   set first_fit
+         *   set next_fit
+         *   set tlsf
          *   set buddy
          *   set cache L1 128 2
+         *   set tlb 16 4 lru
+         *   set vm 48 4
+         *   set policy lru
+         *   set overhead <header> <footer>
+         *   set granularity <bytes>
+         *   set min_split <bytes>
          */
         else if (command == "set")
         {
@@ -178,6 +255,104 @@ int main()
                              l2_size, l2_assoc,
                              l3_size, l3_assoc);
             }
+            // TLB geometry (resets the TLB)
+            else if (target == "tlb" || target == "stlb")
+            {
+                string rest;
+                getline(cin, rest);
+                istringstream args(rest);
+
+                string first;
+                args >> first;
+                if (target == "stlb" && first == "off")
+                {
+                    vm.configure_stlb(0, 1);
+                    cout << "STLB disabled\n";
+                    continue;
+                }
+
+                int entries = 0, assoc = 0;
+                istringstream(first) >> entries;
+                string policy = "lru";
+                args >> assoc >> policy;
+
+                if (entries <= 0 || assoc <= 0 || entries % assoc != 0 ||
+                    (policy != "lru" && policy != "random"))
+                {
+                    cout << "Usage: set tlb <entries> <assoc> [lru|random]"
+                         << " | set stlb <entries> <assoc> | set stlb off\n";
+                    continue;
+                }
+
+                if (target == "tlb")
+                    vm.configure_tlb(entries, assoc,
+                                     policy == "random" ? TLB_RANDOM : TLB_LRU);
+                else
+                    vm.configure_stlb(entries, assoc);
+
+                cout << (target == "tlb" ? "TLB" : "STLB") << " set to "
+                     << entries << " entries, " << assoc << "-way\n";
+            }
+            // Virtual address width and page table depth (resets the VM)
+            else if (target == "vm")
+            {
+                int bits = 0, depth = 0;
+                cin >> bits >> depth;
+
+                if (!vm.set_address_space(bits, depth))
+                {
+                    cout << "Usage: set vm <va_bits> <levels>"
+                         << " (up to 48 bits, 1-5 levels)\n";
+                    continue;
+                }
+
+                cout << "Virtual memory reset: " << bits << "-bit address space, "
+                     << depth << "-level page table\n";
+            }
+            // Page replacement policy (resets the VM)
+            else if (target == "policy")
+            {
+                string rest;
+                getline(cin, rest);
+                istringstream args(rest);
+
+                string name;
+                int param = 0;
+                args >> name >> param;
+
+                PageReplacement p;
+                if (!parse_replacement(name, p) || p == OPT_REPL || param < 0)
+                {
+                    cout << "Usage: set policy fifo|clock|lru"
+                         << " | nfu|aging [interval] | wsclock [window]"
+                         << " (opt needs the future: use vm_compare)\n";
+                    continue;
+                }
+
+                if (param > 0 && p == WSCLOCK_REPL)
+                    vm.ws_window = param;
+                else if (param > 0)
+                    vm.aging_interval = param;
+
+                vm.set_policy(p);
+                cout << "Page replacement set to " << name
+                     << " (virtual memory reset)\n";
+            }
+            // Block layout of the current heap
+            else if (target == "overhead")
+            {
+                cin >> current_heap->header_size >> current_heap->footer_size;
+            }
+            else if (target == "granularity")
+            {
+                size_t g;
+                cin >> g;
+                current_heap->granularity = (g == 0) ? 1 : g;
+            }
+            else if (target == "min_split")
+            {
+                cin >> current_heap->min_split;
+            }
             // Allocator selection
             else
             {
@@ -196,6 +371,16 @@ int main()
                     use_buddy = false;
                     current_allocator = WORST_FIT;
                 }
+                else if (target == "next_fit")
+                {
+                    use_buddy = false;
+                    current_allocator = NEXT_FIT;
+                }
+                else if (target == "tlsf")
+                {
+                    use_buddy = false;
+                    current_allocator = TLSF;
+                }
                 else if (target == "buddy")
                 {
                     use_buddy = true;
@@ -216,7 +401,20 @@ int main()
         }
 
         /*
-         * Access a virtual address.
+         * Verify the structural invariants of the current heap.
+         */
+        else if (command == "check")
+        {
+            string error;
+            if (current_heap->check_invariants(error))
+                cout << "Heap invariants hold\n";
+            else
+                cout << "Heap invariant violated: " << error << "\n";
+        }
+
+        /*
+         * Access a virtual address (a read unless marked w).
+         * Usage: access <address> [r|w]
          * Flow:
          *   Virtual Address → Page Table → Physical Address → Cache Hierarchy
          */
@@ -225,6 +423,15 @@ int main()
             size_t vaddr;
             cin >> hex >> vaddr >> dec;
 
+            string rest, mode;
+            getline(cin, rest);
+            istringstream(rest) >> mode;
+            if (mode != "" && mode != "r" && mode != "w")
+            {
+                cout << "Usage: access <address> [r|w]\n";
+                continue;
+            }
+
             size_t vmem_size = vm.get_virtual_memory_size();
             if (vaddr >= vmem_size)
             {
@@ -235,7 +442,8 @@ int main()
             }
 
             total_memory_accesses++;
-            size_t paddr = vm.translate(vaddr);
+            size_t paddr = vm.translate(vaddr, mode == "w" ? WRITE_ACCESS
+                                                           : READ_ACCESS);
             cache.access(paddr);
         }
 
@@ -255,6 +463,29 @@ int main()
             vm.stats();
         }
 
+        /*
+         * Replay a script's accesses through every replacement policy.
+         *   vm_compare <script> [frames]
+         */
+        else if (command == "vm_compare")
+        {
+            string rest;
+            getline(cin, rest);
+            istringstream in(rest);
+
+            string path;
+            int frames = 0;
+            in >> path >> frames;
+
+            if (path.empty())
+            {
+                cout << "Usage: vm_compare <script> [frames]\n";
+                continue;
+            }
+
+            run_vm_compare(path, frames, vm);
+        }
+
         /*
          * Dump buddy allocator free lists.
          */
@@ -265,13 +496,400 @@ int main()
 
         /*
          * Free a buddy-allocated block.
-         * Usage: buddy_free 0x<address> <size>
+         * Usage: buddy_free 0x<address> [size]
+         * The size is optional; if given it must match the block.
          */
         else if (command == "buddy_free")
         {
             size_t addr, size;
-            cin >> hex >> addr >> dec >> size;
-            buddy.free_block(addr, size);
+            cin >> hex >> addr >> dec;
+
+            string rest;
+            getline(cin, rest);
+            istringstream extra(rest);
+
+            if (extra >> size)
+                buddy.free_block(addr, size);
+            else
+                buddy.free_block(addr);
+        }
+
+        /*
+         * Print buddy allocator statistics.
+         */
+        else if (command == "buddy_stats")
+        {
+            buddy.stats();
+        }
+
+        /*
+         * Verify the structural invariants of the buddy allocator.
+         */
+        else if (command == "buddy_check")
+        {
+            string error;
+            if (buddy.check_invariants(error))
+                cout << "Buddy invariants hold\n";
+            else
+                cout << "Buddy invariant violated: " << error << "\n";
+        }
+
+        /*
+         * Create a slab cache for one object size.
+         * Usage: slab_create <object_size>
+         */
+        else if (command == "slab_create")
+        {
+            size_t size;
+            cin >> size;
+
+            int cache = slabs.create_cache(size);
+            if (cache == -1)
+                cout << "Cannot create slab cache for size " << size << endl;
+            else
+                cout << "Slab cache " << cache << " serves "
+                     << size << "-byte objects\n";
+        }
+
+        /*
+         * Allocate an object from the smallest slab cache that fits.
+         * Usage: slab_alloc <size>
+         */
+        else if (command == "slab_alloc")
+        {
+            size_t size;
+            cin >> size;
+            slabs.allocate(size);
+        }
+
+        /*
+         * Free a slab object.
+         * Usage: slab_free 0x<address>
+         */
+        else if (command == "slab_free")
+        {
+            size_t addr;
+            cin >> hex >> addr >> dec;
+            slabs.free_object(addr);
+        }
+
+        /*
+         * Print slab utilization and fragmentation statistics.
+         */
+        else if (command == "slab_stats")
+        {
+            slabs.stats();
+        }
+
+        /*
+         * Print the free-block size histogram of the current heap.
+         */
+        else if (command == "frag_histogram")
+        {
+            frag_histogram();
+        }
+
+        /*
+         * Compact the current heap, or configure compaction on
+         * allocation failure.
+         * Usage: compact
+         *        compact auto <budget_bytes>   (0 = no limit)
+         *        compact off
+         */
+        else if (command == "compact")
+        {
+            string rest, mode;
+            getline(cin, rest);
+            istringstream args(rest);
+
+            if (args >> mode)
+            {
+                size_t budget = 0;
+                if (mode == "auto" && (args >> budget || budget == 0))
+                {
+                    current_heap->auto_compact = true;
+                    current_heap->compact_budget = budget;
+                    cout << "Compaction on allocation failure enabled";
+                    if (budget)
+                        cout << " (budget " << budget << " bytes)";
+                    cout << endl;
+                }
+                else if (mode == "off")
+                {
+                    current_heap->auto_compact = false;
+                    cout << "Compaction on allocation failure disabled\n";
+                }
+                else
+                {
+                    cout << "Usage: compact [auto <budget> | off]\n";
+                }
+                continue;
+            }
+
+            CompactionResult moved = compact_memory();
+            cout << "Compaction moved " << moved.relocation.size()
+                 << " blocks (" << moved.bytes_moved << " bytes)\n";
+            for (auto &r : moved.relocation)
+                cout << "  0x" << hex << r.first << " -> 0x"
+                     << r.second << dec << endl;
+        }
+
+        /*
+         * Carve an arena from the current heap with the current strategy.
+         * Usage: arena_create <capacity>
+         */
+        else if (command == "arena_create")
+        {
+            size_t capacity;
+            cin >> capacity;
+
+            int arena = current_heap->arena_create(capacity, current_allocator);
+            if (arena == -1)
+                cout << "Arena creation failed\n";
+            else
+                cout << "Arena " << arena << " created at 0x" << hex
+                     << current_heap->arenas[arena].base << dec
+                     << " (" << capacity << " bytes, block id="
+                     << current_heap->arenas[arena].block_id << ")\n";
+        }
+
+        /*
+         * Bump-allocate an object from an arena.
+         * Usage: arena_alloc <arena> <size>
+         */
+        else if (command == "arena_alloc")
+        {
+            int arena;
+            size_t size;
+            cin >> arena >> size;
+
+            size_t addr = current_heap->arena_alloc(arena, size);
+            if (addr == (size_t)-1)
+                cout << "Arena allocation failed\n";
+            else
+                cout << "Arena " << arena << " allocated " << size
+                     << " bytes at 0x" << hex << addr << dec << endl;
+        }
+
+        /*
+         * Free every object in an arena at once.
+         * Usage: arena_reset <arena>
+         */
+        else if (command == "arena_reset")
+        {
+            int arena;
+            cin >> arena;
+
+            if (current_heap->arena_reset(arena))
+                cout << "Arena " << arena << " reset\n";
+            else
+                cout << "No arena " << arena << endl;
+        }
+
+        /*
+         * Return an arena's region to the heap.
+         * Usage: arena_destroy <arena>
+         */
+        else if (command == "arena_destroy")
+        {
+            int arena;
+            cin >> arena;
+
+            if (current_heap->arena_destroy(arena))
+                cout << "Arena " << arena << " destroyed\n";
+            else
+                cout << "No arena " << arena << endl;
+        }
+
+        /*
+         * Print arena statistics of the current heap.
+         */
+        else if (command == "arena_stats")
+        {
+            current_heap->arena_stats();
+        }
+
+        /*
+         * Compare per-object frees with arena resets.
+         * Usage: arena_bench <requests> <objects_per_request>
+         */
+        else if (command == "arena_bench")
+        {
+            int requests, objects;
+            cin >> requests >> objects;
+
+            if (requests < 1 || objects < 1)
+            {
+                cout << "Usage: arena_bench <requests> <objects>\n";
+                continue;
+            }
+
+            run_arena_benchmark(requests, objects);
+        }
+
+        /*
+         * Create a new named heap and make it current.
+         * Usage: heap_create <name>   (then: init memory <size>)
+         */
+        else if (command == "heap_create")
+        {
+            string name;
+            cin >> name;
+
+            if (heaps.count(name))
+            {
+                cout << "Heap " << name << " already exists\n";
+                continue;
+            }
+
+            current_heap = &heaps[name];
+            current_heap_name = name;
+            cout << "Heap " << name << " created and selected\n";
+        }
+
+        /*
+         * Select the heap used by the allocator commands.
+         * Usage: heap_use <name>
+         */
+        else if (command == "heap_use")
+        {
+            string name;
+            cin >> name;
+
+            auto found = heaps.find(name);
+            if (found == heaps.end())
+            {
+                cout << "No heap named " << name << endl;
+                continue;
+            }
+
+            current_heap = &found->second;
+            current_heap_name = name;
+            cout << "Using heap " << name << endl;
+        }
+
+        /*
+         * Delete a heap other than the current one.
+         * Usage: heap_destroy <name>
+         */
+        else if (command == "heap_destroy")
+        {
+            string name;
+            cin >> name;
+
+            if (name == current_heap_name)
+                cout << "Cannot destroy the heap in use\n";
+            else if (heaps.erase(name) == 0)
+                cout << "No heap named " << name << endl;
+            else
+                cout << "Heap " << name << " destroyed\n";
+        }
+
+        /*
+         * List the heaps; the current one is marked with '*'.
+         */
+        else if (command == "heap_list")
+        {
+            for (auto &entry : heaps)
+            {
+                const Heap &h = entry.second;
+                cout << (entry.first == current_heap_name ? "* " : "  ")
+                     << entry.first << ": " << h.total_memory << " bytes, "
+                     << (h.backend == TAGGED_HEAP ? "tagged" : "list")
+                     << ", " << h.alloc_success << "/" << h.alloc_requests
+                     << " allocations\n";
+            }
+        }
+
+        /*
+         * Multi-threaded allocator scaling benchmark.
+         * Usage: bench_mt <buddy|list> <max_threads> <ops_per_thread>
+         */
+        else if (command == "bench_mt")
+        {
+            string backend;
+            int threads, ops;
+            cin >> backend >> threads >> ops;
+
+            if ((backend != "buddy" && backend != "list") ||
+                threads < 1 || ops < 1)
+            {
+                cout << "Usage: bench_mt <buddy|list> <threads> <ops>\n";
+                continue;
+            }
+
+            run_concurrent_benchmark(backend == "buddy" ? CENTRAL_BUDDY
+                                                        : CENTRAL_LIST,
+                                     threads, ops);
+        }
+
+        /*
+         * Compare the simulator allocators on real mmap'd memory
+         * against glibc malloc.
+         * Usage: bench_real <ops>
+         */
+        else if (command == "bench_real")
+        {
+            int ops;
+            cin >> ops;
+
+            if (ops < 1)
+            {
+                cout << "Usage: bench_real <ops>\n";
+                continue;
+            }
+
+            run_real_benchmark(ops);
+        }
+
+        /*
+         * Replay a binary malloc/free trace recorded with libmemtrace.so
+         * through every strategy.
+         * Usage: trace_replay <file> <heap_size> [samples]
+         */
+        else if (command == "trace_replay")
+        {
+            string rest;
+            getline(cin, rest);
+            istringstream in(rest);
+
+            string path;
+            size_t heap_size = 0;
+            int samples = 10;
+            in >> path >> heap_size;
+            if (!(in >> samples))
+                samples = 10;
+
+            if (path.empty() || heap_size == 0 || samples < 1)
+            {
+                cout << "Usage: trace_replay <file> <heap_size> [samples]\n";
+                continue;
+            }
+
+            run_trace_replay(path, heap_size, samples);
+        }
+
+        /*
+         * Run one malloc/free stream through every strategy at once.
+         * Usage: compare <script|trace> [heap_size]
+         */
+        else if (command == "compare")
+        {
+            string rest;
+            getline(cin, rest);
+            istringstream in(rest);
+
+            string path;
+            size_t heap_size = 0;
+            in >> path >> heap_size;
+
+            if (path.empty())
+            {
+                cout << "Usage: compare <script|trace> [heap_size]\n";
+                continue;
+            }
+
+            run_compare(path, heap_size);
         }
 
         /*
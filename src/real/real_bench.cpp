@@ -0,0 +1,233 @@
+#include "sim_malloc.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+/*
+ * Region size given to each simulator allocator.
+ */
+static const size_t REGION_SIZE = (size_t)1 << 26;
+
+/*
+ * Live objects the workload keeps at most, and the number of
+ * operations between two read passes over all live objects.
+ */
+static const size_t MAX_LIVE = 4096;
+static const int SCAN_INTERVAL = 1000;
+
+/*
+ * One workload step: allocate `size` bytes into slot `slot`,
+ * or free slot `slot` when `size` is 0.
+ */
+struct RealOp {
+    size_t slot;
+    size_t size;
+};
+
+/*
+ * Receives the read-pass sums so the reads are not optimized away.
+ */
+static volatile unsigned long scan_sink;
+
+/*
+ * Timings of one run.
+ */
+struct RealResult {
+    double alloc_ns = 0;   // malloc + free + writing new objects
+    double scan_ns = 0;    // Read passes over the live objects
+    long failures = 0;
+    long misaligned = 0;   // Pointers not aligned to RealHeap::ALIGNMENT
+};
+
+/*
+ * Draws a request size: mostly small objects, some medium ones
+ * and an occasional page-sized one.
+ */
+static size_t draw_size(mt19937 &rng)
+{
+    int p = rng() % 100;
+    if (p < 80)
+        return 16 + rng() % 241;
+    if (p < 98)
+        return 257 + rng() % 1792;
+    return 4096 + rng() % 4097;
+}
+
+/*
+ * Builds the workload once so every allocator replays exactly the
+ * same sequence. Live objects are kept in slots; a free picks a
+ * random live slot.
+ */
+static vector<RealOp> build_workload(int ops)
+{
+    mt19937 rng(2024);
+    vector<RealOp> trace;
+    vector<size_t> live, spare;
+    size_t slots = 0;
+
+    trace.reserve(ops);
+    for (int i = 0; i < ops; i++)
+    {
+        bool do_alloc = live.empty() ||
+                        (live.size() < MAX_LIVE && rng() % 100 < 55);
+        RealOp op;
+
+        if (do_alloc)
+        {
+            if (spare.empty())
+                spare.push_back(slots++);
+            op.slot = spare.back();
+            spare.pop_back();
+            op.size = draw_size(rng);
+            live.push_back(op.slot);
+        }
+        else
+        {
+            size_t k = rng() % live.size();
+            op.slot = live[k];
+            op.size = 0;
+            live[k] = live.back();
+            live.pop_back();
+            spare.push_back(op.slot);
+        }
+        trace.push_back(op);
+    }
+    return trace;
+}
+
+/*
+ * Replays the workload through one malloc/free pair. Every new
+ * object is written in full; every SCAN_INTERVAL operations one
+ * byte per cache line of every live object is read, so placement
+ * decisions show up as cache behaviour.
+ */
+template <typename Alloc, typename Free>
+static RealResult replay(const vector<RealOp> &trace, Alloc alloc, Free release)
+{
+    RealResult r;
+    size_t slots = 0;
+    for (size_t i = 0; i < trace.size(); i++)
+        if (trace[i].slot + 1 > slots)
+            slots = trace[i].slot + 1;
+
+    vector<char *> ptr(slots, nullptr);
+    vector<size_t> size(slots, 0);
+
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+        const RealOp &op = trace[i];
+
+        auto begin = chrono::steady_clock::now();
+        if (op.size)
+        {
+            char *p = static_cast<char *>(alloc(op.size));
+            if (p == nullptr)
+                r.failures++;
+            else
+                memset(p, (int)(i & 0xFF), op.size);
+            if (p != nullptr && (uintptr_t)p % RealHeap::ALIGNMENT != 0)
+                r.misaligned++;
+            ptr[op.slot] = p;
+            size[op.slot] = op.size;
+        }
+        else if (ptr[op.slot] != nullptr)
+        {
+            release(ptr[op.slot]);
+            ptr[op.slot] = nullptr;
+        }
+        auto end = chrono::steady_clock::now();
+        r.alloc_ns += chrono::duration<double, nano>(end - begin).count();
+
+        if ((i + 1) % SCAN_INTERVAL == 0)
+        {
+            begin = chrono::steady_clock::now();
+            unsigned long sum = 0;
+            for (size_t s = 0; s < slots; s++)
+                if (ptr[s] != nullptr)
+                    for (size_t b = 0; b < size[s]; b += 64)
+                        sum += (unsigned char)ptr[s][b];
+            end = chrono::steady_clock::now();
+            r.scan_ns += chrono::duration<double, nano>(end - begin).count();
+            scan_sink += sum;
+        }
+    }
+
+    for (size_t s = 0; s < slots; s++)
+        if (ptr[s] != nullptr)
+            release(ptr[s]);
+    return r;
+}
+
+/*
+ * Prints one table row.
+ */
+static void print_row(const string &name, const RealResult &r, int ops,
+                      double baseline)
+{
+    double per_op = r.alloc_ns / ops;
+
+    cout << left << setw(12) << name
+         << right << fixed << setprecision(1)
+         << setw(12) << per_op
+         << setw(14) << r.scan_ns / 1e6
+         << setw(10) << (baseline > 0 ? per_op / baseline : 0) << "x"
+         << setw(9) << r.failures
+         << setw(12) << r.misaligned << "\n";
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
+/*
+ * Runs the workload through glibc malloc and through every simulator
+ * allocator on real memory and prints one row per allocator.
+ */
+void run_real_benchmark(int ops)
+{
+    vector<RealOp> trace = build_workload(ops);
+
+    cout << "Real-memory benchmark: " << ops << " ops, "
+         << REGION_SIZE << "-byte region per allocator\n";
+    cout << setfill(' ') << left << setw(12) << "allocator"
+         << right << setw(12) << "ns/op" << setw(14) << "scan ms"
+         << setw(11) << "vs glibc" << setw(9) << "failed"
+         << setw(12) << "misaligned" << "\n";
+
+    RealResult glibc = replay(trace,
+                              [](size_t n) { return malloc(n); },
+                              [](void *p) { free(p); });
+    double baseline = glibc.alloc_ns / ops;
+    print_row("glibc", glibc, ops, baseline);
+
+    const AllocatorType types[] = { FIRST_FIT, BEST_FIT, WORST_FIT,
+                                    NEXT_FIT, TLSF };
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++)
+    {
+        RealHeap heap;
+        if (!heap.init(types[t], REGION_SIZE))
+        {
+            cout << "Failed to map region\n";
+            return;
+        }
+        RealResult r = replay(trace,
+                              [&](size_t n) { return heap.allocate(n); },
+                              [&](void *p) { heap.release(p); });
+        print_row(allocator_name(types[t]), r, ops, baseline);
+    }
+
+    RealHeap buddy;
+    if (!buddy.init_buddy(REGION_SIZE, 16))
+    {
+        cout << "Failed to map region\n";
+        return;
+    }
+    RealResult r = replay(trace,
+                          [&](size_t n) { return buddy.allocate(n); },
+                          [&](void *p) { buddy.release(p); });
+    print_row("buddy", r, ops, baseline);
+}
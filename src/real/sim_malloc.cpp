@@ -0,0 +1,169 @@
+#include "sim_malloc.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+const size_t RealHeap::ALIGNMENT;
+
+/*
+ * Maps an anonymous, zero-filled region of `size` bytes.
+ */
+bool RealHeap::map_region(size_t size)
+{
+    shutdown();
+    if (size == 0)
+        return false;
+
+#ifdef _WIN32
+    void *p = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT,
+                           PAGE_READWRITE);
+    if (p == nullptr)
+        return false;
+#else
+    void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        return false;
+#endif
+
+    base = static_cast<char *>(p);
+    length = size;
+    return true;
+}
+
+/*
+ * Maps the region and lays a list heap over it.
+ */
+bool RealHeap::init(AllocatorType type, size_t size)
+{
+    if (!map_region(size))
+        return false;
+
+    use_buddy = false;
+    strategy = type;
+
+    // The region is page aligned; keeping every block size (and the
+    // header in front of the payload) a multiple of ALIGNMENT keeps
+    // every payload aligned
+    heap.granularity = ALIGNMENT;
+    heap.header_size = 0;
+    heap.footer_size = 0;
+    heap.init(size / ALIGNMENT * ALIGNMENT);
+    return true;
+}
+
+/*
+ * Validates the buddy geometry, then maps the region and lays a
+ * buddy allocator over it.
+ */
+bool RealHeap::init_buddy(size_t size, size_t min_block)
+{
+    // Both sizes must be powers of two
+    if (size == 0 || min_block == 0 ||
+        (size & (size - 1)) || (min_block & (min_block - 1)))
+        return false;
+
+    // Buddy blocks are aligned to their size
+    if (min_block < ALIGNMENT)
+        min_block = ALIGNMENT;
+    if (min_block > size)
+        return false;
+
+    if (!map_region(size))
+        return false;
+
+    use_buddy = true;
+    buddy = BuddyAllocator(size, min_block);
+    buddy.verbose = false;
+    return true;
+}
+
+/*
+ * Places the request with the selected allocator (silently, without
+ * the per-request timing of Heap::place_block) and converts the
+ * simulated address into a pointer into the region.
+ */
+void *RealHeap::allocate(size_t size)
+{
+    if (base == nullptr)
+        return nullptr;
+
+    if (use_buddy)
+    {
+        size_t addr = buddy.allocate(size);
+        if (addr == (size_t)-1)
+        {
+            failures++;
+            return nullptr;
+        }
+        return base + addr;
+    }
+
+    Block b;
+    if (!heap.place(strategy, size, b))
+    {
+        failures++;
+        return nullptr;
+    }
+
+    // The payload follows the block header, if one is configured
+    return base + b.start + heap.header_size;
+}
+
+/*
+ * Maps a pointer back to its simulated block and frees it.
+ */
+void RealHeap::release(void *ptr)
+{
+    char *p = static_cast<char *>(ptr);
+    if (base == nullptr || p < base || p >= base + length)
+        return;
+
+    size_t offset = p - base;
+    if (use_buddy)
+        buddy.free_block(offset);
+    else
+        heap.release_address(offset - heap.header_size);
+}
+
+/*
+ * Unmaps the region.
+ */
+void RealHeap::shutdown()
+{
+    if (base == nullptr)
+        return;
+
+#ifdef _WIN32
+    VirtualFree(base, 0, MEM_RELEASE);
+#else
+    munmap(base, length);
+#endif
+
+    base = nullptr;
+    length = 0;
+}
+
+/*
+ * Process-wide heap behind the C-style API.
+ */
+static RealHeap real_heap;
+
+bool sim_init(AllocatorType type, size_t size)
+{
+    return real_heap.init(type, size);
+}
+
+bool sim_init_buddy(size_t size, size_t min_block)
+{
+    return real_heap.init_buddy(size, min_block);
+}
+
+void *sim_malloc(size_t size) { return real_heap.allocate(size); }
+void sim_free(void *ptr)      { real_heap.release(ptr); }
+void sim_shutdown()           { real_heap.shutdown(); }
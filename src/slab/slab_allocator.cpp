@@ -0,0 +1,291 @@
+#include "slab.h"
+#include <iostream>
+
+using namespace std;
+
+const int SlabAllocator::MIN_OBJECTS;
+
+/*
+ * Smallest power of two >= n.
+ */
+static size_t round_pow2(size_t n)
+{
+    return n <= 1 ? 1
+                  : (size_t)1 << (64 - __builtin_clzll((unsigned long long)(n - 1)));
+}
+
+/*
+ * Constructs an empty slab layer over a buddy allocator.
+ */
+SlabAllocator::SlabAllocator(BuddyAllocator *p)
+    : pages(p)
+{}
+
+/*
+ * Forgets every cache and slab.
+ */
+void SlabAllocator::reset()
+{
+    caches.clear();
+    slabs.clear();
+    spare.clear();
+    slab_at.clear();
+}
+
+/*
+ * Creates a cache for one object size.
+ *
+ * The slab size is the smallest power of two holding at least
+ * MIN_OBJECTS objects (and at least one buddy minimum block),
+ * capped at the whole buddy memory.
+ */
+int SlabAllocator::create_cache(size_t object_size)
+{
+    if (object_size == 0 || object_size > pages->total_size)
+        return -1;
+
+    for (size_t i = 0; i < caches.size(); i++)
+    {
+        if (caches[i].object_size == object_size)
+            return (int)i;
+    }
+
+    SlabCache c;
+    c.slab_size = round_pow2(object_size * MIN_OBJECTS);
+    if (c.slab_size < pages->min_block)
+        c.slab_size = pages->min_block;
+    if (c.slab_size > pages->total_size)
+        c.slab_size = pages->total_size;
+    c.object_size = object_size;
+    c.objects_per_slab = (int)(c.slab_size / object_size);
+
+    caches.push_back(c);
+    return (int)caches.size() - 1;
+}
+
+/*
+ * Moves a slab to the list for `state`.
+ */
+void SlabAllocator::move(Slab &slab, int state)
+{
+    SlabCache &c = caches[slab.cache];
+    if (slab.state == state)
+        return;
+
+    c.lists[slab.state].erase(slab.where);
+    c.lists[state].push_front((int)(&slab - &slabs[0]));
+    slab.where = c.lists[state].begin();
+    slab.state = state;
+}
+
+/*
+ * Takes a new slab from the buddy allocator for `cache`.
+ * Returns the slab index, or -1 if the buddy memory is exhausted.
+ */
+int SlabAllocator::grow(int cache)
+{
+    SlabCache &c = caches[cache];
+
+    size_t base = pages->allocate(c.slab_size);
+    if (base == (size_t)-1)
+        return -1;
+
+    int index;
+    if (!spare.empty())
+    {
+        index = spare.back();
+        spare.pop_back();
+    }
+    else
+    {
+        slabs.push_back(Slab());
+        index = (int)slabs.size() - 1;
+    }
+
+    Slab &s = slabs[index];
+    s.base = base;
+    s.cache = cache;
+    s.in_use = 0;
+    s.free_map.assign((c.objects_per_slab + 63) / 64, 0);
+    for (int i = 0; i < c.objects_per_slab; i++)
+        s.free_map[i / 64] |= (uint64_t)1 << (i % 64);
+    s.requested.assign(c.objects_per_slab, 0);
+
+    c.lists[SLAB_EMPTY].push_front(index);
+    s.where = c.lists[SLAB_EMPTY].begin();
+    s.state = SLAB_EMPTY;
+
+    slab_at[base] = index;
+    return index;
+}
+
+/*
+ * Returns an empty slab's block to the buddy allocator.
+ */
+void SlabAllocator::release(int index)
+{
+    Slab &s = slabs[index];
+    caches[s.cache].lists[s.state].erase(s.where);
+    slab_at.erase(s.base);
+    pages->free_block(s.base);
+    spare.push_back(index);
+}
+
+/*
+ * Allocates one object from the smallest cache that fits `size`.
+ *
+ * Partial slabs are preferred, then empty slabs; only when both
+ * lists are empty does the cache grow by one buddy block. The free
+ * object is located with a find-first-set over the slab bitmap.
+ */
+size_t SlabAllocator::allocate(size_t size)
+{
+    int cache = -1;
+    for (size_t i = 0; i < caches.size(); i++)
+    {
+        if (caches[i].object_size >= size &&
+            (cache == -1 || caches[i].object_size < caches[cache].object_size))
+            cache = (int)i;
+    }
+
+    if (size == 0 || cache == -1)
+    {
+        cout << "No slab cache fits size " << size << endl;
+        return (size_t)-1;
+    }
+
+    SlabCache &c = caches[cache];
+
+    int index;
+    if (!c.lists[SLAB_PARTIAL].empty())
+        index = c.lists[SLAB_PARTIAL].front();
+    else if (!c.lists[SLAB_EMPTY].empty())
+        index = c.lists[SLAB_EMPTY].front();
+    else if ((index = grow(cache)) == -1)
+    {
+        cout << "Slab allocation failed: buddy memory exhausted\n";
+        return (size_t)-1;
+    }
+
+    Slab &s = slabs[index];
+
+    // First free object in the slab bitmap
+    size_t word = 0;
+    while (s.free_map[word] == 0)
+        word++;
+    int obj = (int)(word * 64 + __builtin_ctzll(s.free_map[word]));
+
+    s.free_map[word] &= ~((uint64_t)1 << (obj % 64));
+    s.requested[obj] = size;
+    s.in_use++;
+    move(s, s.in_use == c.objects_per_slab ? SLAB_FULL : SLAB_PARTIAL);
+
+    // Raw buddy would round each request to a power of two
+    size_t raw = round_pow2(size);
+    if (raw < pages->min_block)
+        raw = pages->min_block;
+
+    c.objects_in_use++;
+    c.requested_bytes += size;
+    c.buddy_equivalent += raw;
+
+    size_t addr = s.base + obj * c.object_size;
+    cout << "Slab allocated object at 0x" << hex << addr << dec
+         << " (cache " << c.object_size << " bytes)\n";
+    return addr;
+}
+
+/*
+ * Frees an object. The owning slab is found by aligning the address
+ * down to each cache's slab size (buddy blocks are size-aligned).
+ */
+bool SlabAllocator::free_object(size_t addr)
+{
+    for (size_t i = 0; i < caches.size(); i++)
+    {
+        SlabCache &c = caches[i];
+        auto found = slab_at.find(addr & ~(c.slab_size - 1));
+        if (found == slab_at.end())
+            continue;
+
+        Slab &s = slabs[found->second];
+        if (s.cache != (int)i)
+            continue;
+
+        size_t offset = addr - s.base;
+        int obj = (int)(offset / c.object_size);
+        if (offset % c.object_size != 0 || obj >= c.objects_per_slab ||
+            ((s.free_map[obj / 64] >> (obj % 64)) & 1))
+            break;
+
+        // Return the object to its slab
+        s.free_map[obj / 64] |= (uint64_t)1 << (obj % 64);
+        s.in_use--;
+
+        size_t raw = round_pow2(s.requested[obj]);
+        if (raw < pages->min_block)
+            raw = pages->min_block;
+        c.objects_in_use--;
+        c.requested_bytes -= s.requested[obj];
+        c.buddy_equivalent -= raw;
+
+        cout << "Slab freed object at 0x" << hex << addr << dec << endl;
+
+        if (s.in_use > 0)
+        {
+            move(s, SLAB_PARTIAL);
+            return true;
+        }
+
+        // Keep one empty slab per cache; give the rest back to buddy
+        if (c.lists[SLAB_EMPTY].empty())
+            move(s, SLAB_EMPTY);
+        else
+            release(found->second);
+        return true;
+    }
+
+    cout << "Invalid or double slab free at 0x"
+         << hex << addr << dec << endl;
+    return false;
+}
+
+/*
+ * Prints utilization and internal fragmentation for each cache.
+ *
+ * Utilization is requested bytes over the bytes held in slabs.
+ * Internal fragmentation is the padding between each live request
+ * and its object size.
+ * The buddy comparison shows what the same live requests would
+ * occupy if each were served directly by the buddy allocator.
+ */
+void SlabAllocator::stats()
+{
+    cout << "\n--- Slab Statistics ---\n";
+    if (caches.empty())
+        cout << "No slab caches\n";
+
+    for (auto &c : caches)
+    {
+        size_t full = c.lists[SLAB_FULL].size();
+        size_t partial = c.lists[SLAB_PARTIAL].size();
+        size_t empty = c.lists[SLAB_EMPTY].size();
+        size_t slab_bytes = (full + partial + empty) * c.slab_size;
+
+        double utilization = slab_bytes == 0 ? 0 :
+            (double)c.requested_bytes / slab_bytes * 100;
+
+        cout << "Cache " << c.object_size << " bytes: "
+             << c.objects_per_slab << " objects per " << c.slab_size
+             << "-byte slab\n";
+        cout << "  Slabs: " << full << " full, " << partial
+             << " partial, " << empty << " empty\n";
+        cout << "  Objects in use: " << c.objects_in_use << "\n";
+        cout << "  Slab utilization: " << utilization << "%\n";
+        cout << "  Internal fragmentation: "
+             << (c.objects_in_use * c.object_size - c.requested_bytes)
+             << " bytes (slab) vs "
+             << (c.buddy_equivalent - c.requested_bytes)
+             << " bytes (raw buddy)\n";
+    }
+}
@@ -0,0 +1,551 @@
+#include "trace.h"
+#include "allocator.h"
+#include "buddy.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+using namespace std;
+
+/*
+ * One operation of the compared stream. Stream IDs number the
+ * allocations from 1 (failed or not); a free names the allocation
+ * it releases.
+ */
+struct StreamOp {
+    bool alloc;       // malloc (true) or free (false)
+    size_t size;      // Requested bytes (malloc only)
+    size_t id;        // Stream ID allocated or freed
+    size_t origin;    // Script line or trace record it came from
+};
+
+/*
+ * Per-strategy outcome of a comparison run.
+ */
+struct CompareResult {
+    string name;
+    vector<char> outcome;    // Per op: 1 if it succeeded / freed a block
+    long allocs = 0;
+    long success = 0;
+    size_t memory = 0;       // Heap size given to the strategy
+    size_t peak_used = 0;
+    double ext_sum = 0, ext_peak = 0;   // External fragmentation (%)
+    double int_sum = 0, int_peak = 0;   // Internal fragmentation (%)
+    double total_ns = 0;     // Time spent in allocate + free
+};
+
+static const size_t UNMAPPED = (size_t)-1;
+
+/*
+ * Parses the malloc/free lines of a command script.
+ *
+ * `free <id>` names a CLI block ID, and the CLI numbers only the
+ * placements that succeed, so the script is replayed on a reference
+ * heap set up as the CLI would set it up (init, strategy, block layout
+ * and compaction lines). That tells which malloc received which ID,
+ * and which block a `free 0x<address>` releases. A malloc that fails
+ * in the replay still enters the stream, but nothing frees it.
+ *
+ * Commands whose effect on block IDs is not replayed make the script
+ * unsupported: a second init, malloc_aligned, realloc, arena_create,
+ * buddy placement and heap switching.
+ */
+static bool load_script(const string &path, vector<StreamOp> &ops,
+                        size_t &heap_size)
+{
+    ifstream in(path.c_str());
+    if (!in)
+    {
+        cout << "Cannot open " << path << "\n";
+        return false;
+    }
+
+    Heap cli;                                 // The CLI's heap, replayed
+    AllocatorType strategy = FIRST_FIT;
+    unordered_map<int, size_t> stream_id;     // Live CLI block ID → stream ID
+    bool initialized = false;
+
+    string line;
+    size_t line_no = 0, next_id = 1;
+    while (getline(in, line))
+    {
+        line_no++;
+        istringstream words(line);
+        string command, arg;
+        words >> command;
+
+        bool unsupported = command == "malloc_aligned" ||
+                           command == "realloc" ||
+                           command == "arena_create" ||
+                           command == "heap_create" || command == "heap_use";
+
+        StreamOp op;
+        op.origin = line_no;
+        if (command == "malloc" && words >> op.size)
+        {
+            op.alloc = true;
+            op.id = next_id++;
+            ops.push_back(op);
+
+            Block b;
+            if (cli.place_block(strategy, op.size, b))
+                stream_id[b.id] = op.id;
+        }
+        else if (command == "free" && words >> arg)
+        {
+            int freed = -1;
+            istringstream value(arg);
+            if (arg.find("0x") == 0 || arg.find("0X") == 0)
+            {
+                size_t address;
+                if (value >> hex >> address)
+                    freed = cli.release_address(address);
+            }
+            else
+            {
+                int id;
+                if (value >> id)
+                    freed = cli.release_id(id);
+            }
+
+            auto found = stream_id.find(freed);
+            if (found != stream_id.end())
+            {
+                op.alloc = false;
+                op.size = 0;
+                op.id = found->second;
+                ops.push_back(op);
+                stream_id.erase(found);
+            }
+        }
+        else if (command == "init")
+        {
+            string kind;
+            size_t size;
+            if (words >> kind >> size && (kind == "memory" || kind == "tagged"))
+            {
+                unsupported = initialized;
+                initialized = true;
+                cli.init(size, kind == "tagged" ? TAGGED_HEAP : LIST_HEAP);
+                if (heap_size == 0)
+                    heap_size = size;
+            }
+        }
+        else if (command == "set" && words >> arg)
+        {
+            size_t g;
+            if (arg == "first_fit")
+                strategy = FIRST_FIT;
+            else if (arg == "best_fit")
+                strategy = BEST_FIT;
+            else if (arg == "worst_fit")
+                strategy = WORST_FIT;
+            else if (arg == "next_fit")
+                strategy = NEXT_FIT;
+            else if (arg == "tlsf")
+                strategy = TLSF;
+            else if (arg == "buddy")
+                unsupported = true;
+            else if (arg == "overhead")
+                words >> cli.header_size >> cli.footer_size;
+            else if (arg == "min_split")
+                words >> cli.min_split;
+            else if (arg == "granularity" && words >> g)
+                cli.granularity = (g == 0) ? 1 : g;
+        }
+        else if (command == "compact")
+        {
+            if (!(words >> arg))
+                cli.compact();
+            else if (arg == "off")
+                cli.auto_compact = false;
+            else if (arg == "auto")
+            {
+                cli.auto_compact = true;
+                cli.compact_budget = 0;
+                words >> cli.compact_budget;
+            }
+        }
+        else if (command == "exit")
+        {
+            break;
+        }
+
+        if (unsupported)
+        {
+            cout << path << ":" << line_no << ": '" << line
+                 << "' is not supported by compare (block IDs would not "
+                 << "match the CLI's)\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Converts a binary trace into a stream. Each traced pointer is
+ * given a stream ID when returned; a moving realloc becomes an
+ * allocation of the new size followed by a free of the old block.
+ */
+static void trace_to_stream(const vector<TraceRecord> &records,
+                            vector<StreamOp> &ops)
+{
+    unordered_map<uint64_t, size_t> id_of;   // Live pointer → stream ID
+    size_t next_id = 1;
+
+    auto emit_free = [&](uint64_t ptr, size_t origin) {
+        auto found = id_of.find(ptr);
+        if (found == id_of.end())
+            return;
+        StreamOp op = { false, 0, found->second, origin };
+        ops.push_back(op);
+        id_of.erase(found);
+    };
+
+    auto emit_alloc = [&](size_t size, size_t origin) {
+        StreamOp op = { true, size ? size : 1, next_id++, origin };
+        ops.push_back(op);
+        return op.id;
+    };
+
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const TraceRecord &r = records[i];
+
+        if (r.op == TRACE_FREE)
+        {
+            emit_free(r.ptr, i + 1);
+        }
+        else if (r.op == TRACE_REALLOC && r.old_ptr != 0)
+        {
+            if (r.ptr != 0)
+            {
+                size_t id = emit_alloc(r.size, i + 1);
+                emit_free(r.old_ptr, i + 1);
+                emit_free(r.ptr, i + 1);
+                id_of[r.ptr] = id;
+            }
+            else if (r.size == 0)
+            {
+                emit_free(r.old_ptr, i + 1);
+            }
+        }
+        else if (r.ptr != 0)
+        {
+            emit_free(r.ptr, i + 1);
+            id_of[r.ptr] = emit_alloc(r.size, i + 1);
+        }
+    }
+}
+
+/*
+ * Records the fragmentation of one step.
+ */
+static void record_sample(CompareResult &res, size_t used, size_t requested,
+                          size_t free_bytes, size_t largest)
+{
+    double ext = free_bytes ? (1.0 - (double)largest / free_bytes) * 100 : 0;
+    double internal = used ? 100.0 * (used - requested) / used : 0;
+
+    res.ext_sum += ext;
+    res.int_sum += internal;
+    res.ext_peak = max(res.ext_peak, ext);
+    res.int_peak = max(res.int_peak, internal);
+    res.peak_used = max(res.peak_used, used);
+}
+
+/*
+ * CPU time consumed by the calling thread, in nanoseconds. Strategy
+ * threads share the cores, so wall-clock time would also count the
+ * time a thread spends preempted by the others.
+ */
+static double thread_cpu_ns()
+{
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/*
+ * List heap with one placement strategy, driven by run_strategy().
+ */
+struct HeapDriver {
+    AllocatorType type;
+    size_t heap_size, header, footer, granularity, min_split;
+    Heap heap;
+
+    void reset()
+    {
+        heap.init(heap_size);
+        heap.header_size = header;
+        heap.footer_size = footer;
+        heap.granularity = granularity;
+        heap.min_split = min_split;
+    }
+
+    size_t allocate(size_t size)
+    {
+        Block b;
+        return heap.place(type, size, b) ? b.start : UNMAPPED;
+    }
+
+    bool release(size_t address)
+    {
+        return heap.release_address(address) >= 0;
+    }
+
+    void sample(CompareResult &res)
+    {
+        const FreeSpaceStats &fs = heap.free_stats();
+        record_sample(res, heap.used_bytes, heap.requested_bytes,
+                      fs.free_bytes, heap.largest_free());
+    }
+};
+
+/*
+ * Buddy allocator driven by run_strategy(). The heap size is
+ * rounded up to a power of two.
+ */
+struct BuddyDriver {
+    size_t size;
+    BuddyAllocator buddy;
+
+    explicit BuddyDriver(size_t heap_size)
+        : size(round_up(heap_size)), buddy(size, 16)
+    {}
+
+    static size_t round_up(size_t n)
+    {
+        size_t p = 16;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+    void reset()
+    {
+        buddy = BuddyAllocator(size, 16);
+        buddy.verbose = false;
+    }
+
+    size_t allocate(size_t bytes)
+    {
+        size_t addr = buddy.allocate(bytes);
+        return addr == BuddyAllocator::NONE ? UNMAPPED : addr;
+    }
+
+    bool release(size_t address)
+    {
+        return buddy.free_block(address);
+    }
+
+    void sample(CompareResult &res)
+    {
+        record_sample(res, buddy.allocated_bytes, buddy.requested_bytes,
+                      buddy.total_size - buddy.allocated_bytes,
+                      buddy.largest_free());
+    }
+};
+
+/*
+ * Runs the stream through one allocator, on its own thread.
+ *
+ * The first pass only performs the operations and is timed on the
+ * thread's CPU clock. The second pass, on a fresh allocator, records
+ * per-op outcomes and fragmentation (the results are deterministic,
+ * so both passes see the same states).
+ */
+template <typename Driver>
+static void run_strategy(const vector<StreamOp> *ops, Driver *driver,
+                         CompareResult *res)
+{
+    vector<size_t> address;   // Stream ID → block address
+    for (size_t i = 0; i < ops->size(); i++)
+        if ((*ops)[i].id >= address.size())
+            address.resize((*ops)[i].id + 1, UNMAPPED);
+
+    driver->reset();
+    double begin = thread_cpu_ns();
+    for (size_t i = 0; i < ops->size(); i++)
+    {
+        const StreamOp &op = (*ops)[i];
+        if (op.alloc)
+            address[op.id] = driver->allocate(op.size);
+        else if (address[op.id] != UNMAPPED)
+        {
+            driver->release(address[op.id]);
+            address[op.id] = UNMAPPED;
+        }
+    }
+    res->total_ns = thread_cpu_ns() - begin;
+
+    driver->reset();
+    address.assign(address.size(), UNMAPPED);
+    res->outcome.assign(ops->size(), 0);
+
+    for (size_t i = 0; i < ops->size(); i++)
+    {
+        const StreamOp &op = (*ops)[i];
+        if (op.alloc)
+        {
+            address[op.id] = driver->allocate(op.size);
+            res->outcome[i] = address[op.id] != UNMAPPED;
+            res->allocs++;
+            res->success += res->outcome[i];
+        }
+        else if (address[op.id] != UNMAPPED)
+        {
+            res->outcome[i] = driver->release(address[op.id]);
+            address[op.id] = UNMAPPED;
+        }
+        driver->sample(*res);
+    }
+}
+
+/*
+ * Loads the stream, runs every strategy on its own thread and
+ * prints the comparison.
+ */
+void run_compare(const string &path, size_t heap_size)
+{
+    vector<StreamOp> ops;
+    bool from_trace = false;
+
+    // Binary traces start with TRACE_MAGIC; anything else is a script
+    char magic[sizeof(TRACE_MAGIC)] = {};
+    {
+        ifstream probe(path.c_str(), ios::binary);
+        probe.read(magic, sizeof(magic));
+        from_trace = probe && memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0;
+    }
+
+    if (from_trace)
+    {
+        vector<TraceRecord> records;
+        if (!load_trace(path, records))
+            return;
+        trace_to_stream(records, ops);
+    }
+    else if (!load_script(path, ops, heap_size))
+    {
+        return;
+    }
+
+    if (heap_size == 0)
+    {
+        cout << "No heap size given and no 'init memory' line in " << path << "\n";
+        return;
+    }
+    if (ops.empty())
+    {
+        cout << "No malloc/free operations in " << path << "\n";
+        return;
+    }
+
+    const AllocatorType types[] = { FIRST_FIT, BEST_FIT, WORST_FIT,
+                                    NEXT_FIT, TLSF };
+    const int strategies = sizeof(types) / sizeof(types[0]);
+
+    vector<CompareResult> results(strategies + 1);
+    vector<HeapDriver> heaps(strategies);
+    BuddyDriver buddy(heap_size);
+    vector<thread> pool;
+
+    for (int t = 0; t < strategies; t++)
+    {
+        HeapDriver &d = heaps[t];
+        d.type = types[t];
+        d.heap_size = heap_size;
+        d.header = current_heap->header_size;
+        d.footer = current_heap->footer_size;
+        d.granularity = current_heap->granularity;
+        d.min_split = current_heap->min_split;
+
+        results[t].name = allocator_name(types[t]);
+        results[t].memory = heap_size;
+        pool.push_back(thread(run_strategy<HeapDriver>, &ops, &d,
+                              &results[t]));
+    }
+
+    results[strategies].name = "buddy";
+    results[strategies].memory = buddy.size;
+    pool.push_back(thread(run_strategy<BuddyDriver>, &ops, &buddy,
+                          &results[strategies]));
+
+    for (size_t t = 0; t < pool.size(); t++)
+        pool[t].join();
+
+    size_t mallocs = 0;
+    for (size_t i = 0; i < ops.size(); i++)
+        mallocs += ops[i].alloc;
+
+    cout << "Compare " << path << ": " << ops.size() << " ops ("
+         << mallocs << " malloc, " << ops.size() - mallocs << " free), "
+         << heap_size << "-byte heap";
+    if (results[strategies].memory != heap_size)
+        cout << " (buddy: " << results[strategies].memory << ")";
+    cout << "\n";
+
+    cout << left << setw(11) << "strategy" << right
+         << setw(14) << "success" << setw(9) << "rate"
+         << setw(12) << "peak used" << setw(10) << "avg ext"
+         << setw(10) << "peak ext" << setw(10) << "avg int"
+         << setw(10) << "peak int" << setw(10) << "ns/op" << "\n";
+
+    for (size_t k = 0; k < results.size(); k++)
+    {
+        const CompareResult &res = results[k];
+        double n = (double)ops.size();
+
+        ostringstream success;
+        success << res.success << "/" << res.allocs;
+
+        cout << left << setw(11) << res.name << right
+             << setw(14) << success.str()
+             << fixed << setprecision(1)
+             << setw(8) << (res.allocs ? 100.0 * res.success / res.allocs : 0) << "%"
+             << setw(12) << res.peak_used
+             << setw(9) << res.ext_sum / n << "%"
+             << setw(9) << res.ext_peak << "%"
+             << setw(9) << res.int_sum / n << "%"
+             << setw(9) << res.int_peak << "%"
+             << setw(10) << res.total_ns / n << "\n";
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
+
+    // First operation whose outcome is not the same everywhere
+    for (size_t i = 0; i < ops.size(); i++)
+    {
+        bool same = true;
+        for (size_t k = 1; k < results.size(); k++)
+            if (results[k].outcome[i] != results[0].outcome[i])
+                same = false;
+        if (same)
+            continue;
+
+        const StreamOp &op = ops[i];
+        cout << "First divergence at op " << i + 1 << " ("
+             << (from_trace ? "record " : "line ") << op.origin << "): ";
+        if (op.alloc)
+            cout << "malloc " << op.size << " (id " << op.id << ")\n";
+        else
+            cout << "free " << op.id << "\n";
+
+        for (size_t k = 0; k < results.size(); k++)
+            cout << "  " << left << setw(11) << results[k].name
+                 << (results[k].outcome[i] ? "ok" : "failed") << "\n";
+        cout << right;
+        return;
+    }
+
+    cout << "No divergence: every strategy had the same outcome for all "
+         << ops.size() << " ops\n";
+}
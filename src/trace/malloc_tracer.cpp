@@ -0,0 +1,194 @@
+/*
+ * LD_PRELOAD allocation tracer
+ *
+ * Build:  make tracer
+ * Use:    LD_PRELOAD=./libmemtrace.so MEMTRACE_FILE=app <program>
+ *
+ * Interposes malloc, calloc, realloc and free, forwards them to the
+ * glibc implementations and appends one TraceRecord per call to
+ * <MEMTRACE_FILE>.<pid>.trace (default prefix "memtrace"). Records are
+ * buffered and written with write(2), so the tracer itself never
+ * allocates. Linux / glibc only.
+ */
+#include "trace.h"
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+}
+
+/*
+ * Records buffered between two writes.
+ */
+static const size_t BUFFER_RECORDS = 4096;
+
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static TraceRecord buffer[BUFFER_RECORDS];
+static size_t buffered = 0;
+static int trace_fd = -1;
+static bool finished = false;
+
+/*
+ * Per-thread state. initial-exec TLS never calls into the allocator.
+ */
+static __thread int in_tracer __attribute__((tls_model("initial-exec")));
+static __thread uint32_t thread_id __attribute__((tls_model("initial-exec")));
+
+/*
+ * Writes the buffered records (trace_lock held).
+ */
+static void flush_buffer()
+{
+    size_t bytes = buffered * sizeof(TraceRecord);
+    const char *p = reinterpret_cast<const char *>(buffer);
+
+    while (bytes > 0 && trace_fd >= 0)
+    {
+        ssize_t n = write(trace_fd, p, bytes);
+        if (n <= 0)
+            break;
+        p += n;
+        bytes -= n;
+    }
+    buffered = 0;
+}
+
+/*
+ * Opens this process's trace file and writes the header
+ * (trace_lock held).
+ */
+static void open_trace()
+{
+    const char *prefix = getenv("MEMTRACE_FILE");
+    char path[512];
+    snprintf(path, sizeof(path), "%s.%d.trace",
+             prefix ? prefix : "memtrace", (int)getpid());
+
+    trace_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (trace_fd < 0)
+    {
+        finished = true;
+        return;
+    }
+
+    TraceHeader header;
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.record_size = sizeof(TraceRecord);
+    if (write(trace_fd, &header, sizeof(header)) != (ssize_t)sizeof(header))
+    {
+        close(trace_fd);
+        trace_fd = -1;
+        finished = true;
+    }
+}
+
+/*
+ * A forked child starts its own trace file.
+ */
+static void after_fork_child()
+{
+    if (trace_fd >= 0)
+        close(trace_fd);
+    trace_fd = -1;
+    buffered = 0;
+    thread_id = 0;
+    pthread_mutex_init(&trace_lock, nullptr);
+}
+
+__attribute__((constructor)) static void start_tracer()
+{
+    pthread_atfork(nullptr, nullptr, after_fork_child);
+}
+
+__attribute__((destructor)) static void stop_tracer()
+{
+    pthread_mutex_lock(&trace_lock);
+    flush_buffer();
+    if (trace_fd >= 0)
+        close(trace_fd);
+    trace_fd = -1;
+    finished = true;
+    pthread_mutex_unlock(&trace_lock);
+}
+
+/*
+ * Appends one record. Calls made by the tracer itself (through
+ * getenv, snprintf, ...) are not traced.
+ */
+static void record(TraceOp op, void *ptr, void *old_ptr, size_t size)
+{
+    if (in_tracer || finished)
+        return;
+    in_tracer = 1;
+
+    if (thread_id == 0)
+        thread_id = (uint32_t)syscall(SYS_gettid);
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    TraceRecord r;
+    r.time_ns = (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+    r.ptr = (uint64_t)(uintptr_t)ptr;
+    r.old_ptr = (uint64_t)(uintptr_t)old_ptr;
+    r.size = size;
+    r.thread = thread_id;
+    r.op = op;
+
+    pthread_mutex_lock(&trace_lock);
+    if (trace_fd < 0 && !finished)
+        open_trace();
+    if (trace_fd >= 0)
+    {
+        buffer[buffered++] = r;
+        if (buffered == BUFFER_RECORDS)
+            flush_buffer();
+    }
+    pthread_mutex_unlock(&trace_lock);
+
+    in_tracer = 0;
+}
+
+extern "C" {
+
+void *malloc(size_t size)
+{
+    void *p = __libc_malloc(size);
+    record(TRACE_MALLOC, p, nullptr, size);
+    return p;
+}
+
+void *calloc(size_t n, size_t size)
+{
+    void *p = __libc_calloc(n, size);
+    record(TRACE_CALLOC, p, nullptr, n * size);
+    return p;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    void *p = __libc_realloc(ptr, size);
+    record(TRACE_REALLOC, p, ptr, size);
+    return p;
+}
+
+void free(void *ptr)
+{
+    if (ptr == nullptr)
+        return;
+    record(TRACE_FREE, ptr, nullptr, 0);
+    __libc_free(ptr);
+}
+
+}
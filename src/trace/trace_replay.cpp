@@ -0,0 +1,404 @@
+#include "trace.h"
+#include "allocator.h"
+#include "buddy.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstring>
+
+using namespace std;
+
+/*
+ * Fragmentation snapshot taken during a replay.
+ */
+struct ReplaySample {
+    size_t event;          // Records replayed so far
+    size_t live_bytes;     // Bytes requested by live objects
+    size_t used_bytes;     // Bytes in allocated blocks
+    size_t largest_free;   // Largest free block
+    double external;       // External fragmentation (%)
+};
+
+/*
+ * Outcome of replaying a trace through one allocator.
+ */
+struct ReplayResult {
+    string name;
+    vector<ReplaySample> samples;
+    long allocs = 0;       // malloc/calloc/realloc placements attempted
+    long failed = 0;       // Placements the simulated heap could not serve
+    long unmatched = 0;    // Frees / reallocs of pointers never seen
+    long timed = 0;        // Placements whose time is in total_ns
+    double total_ns = 0;   // Time spent in simulated placement
+    size_t peak_used = 0;
+    size_t memory = 0;     // Size of the simulated heap
+};
+
+/*
+ * Reads and validates a trace file.
+ */
+bool load_trace(const string &path, vector<TraceRecord> &records)
+{
+    ifstream in(path.c_str(), ios::binary);
+    if (!in)
+    {
+        cout << "Cannot open trace " << path << "\n";
+        return false;
+    }
+
+    TraceHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TRACE_VERSION ||
+        header.record_size != sizeof(TraceRecord))
+    {
+        cout << "Not a version " << TRACE_VERSION << " trace: " << path << "\n";
+        return false;
+    }
+
+    TraceRecord r;
+    while (in.read(reinterpret_cast<char *>(&r), sizeof(r)))
+        records.push_back(r);
+    return true;
+}
+
+static double external_frag(size_t free_bytes, size_t largest)
+{
+    return free_bytes == 0 ? 0 : (1.0 - (double)largest / free_bytes) * 100;
+}
+
+/*
+ * Replays the trace on a list heap with strategy `type`.
+ * Traced pointers map to simulated block IDs; frees go through the
+ * block's address and reallocs through Heap::realloc.
+ */
+static ReplayResult replay_heap(const vector<TraceRecord> &records,
+                                AllocatorType type, size_t heap_size,
+                                size_t interval)
+{
+    ReplayResult res;
+    res.name = allocator_name(type);
+
+    res.memory = heap_size;
+
+    Heap heap;
+    heap.init(heap_size);
+    heap.header_size = current_heap->header_size;
+    heap.footer_size = current_heap->footer_size;
+    heap.granularity = current_heap->granularity;
+    heap.min_split = current_heap->min_split;
+
+    unordered_map<uint64_t, int> block_of;   // Traced pointer → block ID
+    size_t live_bytes = 0;
+
+    // Drop the simulated block behind a traced pointer
+    auto release = [&](uint64_t ptr) -> bool {
+        auto found = block_of.find(ptr);
+        if (found == block_of.end())
+            return false;
+        if (found->second >= 0)
+        {
+            Block &b = *heap.block_by_id[found->second];
+            live_bytes -= b.requested;
+            heap.release_address(b.start);
+        }
+        block_of.erase(found);
+        return true;
+    };
+
+    auto place = [&](uint64_t ptr, size_t size) {
+        release(ptr);   // A pointer reused without a traced free
+        res.allocs++;
+        if (size == 0)
+            size = 1;   // malloc(0) still returns a unique pointer
+        Block b;
+        if (heap.place_block(type, size, b))
+        {
+            block_of[ptr] = b.id;
+            live_bytes += size;
+        }
+        else
+        {
+            block_of[ptr] = -1;
+            res.failed++;
+        }
+    };
+
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const TraceRecord &r = records[i];
+
+        if (r.op == TRACE_FREE)
+        {
+            if (!release(r.ptr))
+                res.unmatched++;
+        }
+        else if (r.op == TRACE_REALLOC && r.old_ptr != 0)
+        {
+            auto found = block_of.find(r.old_ptr);
+            if (found == block_of.end())
+            {
+                res.unmatched++;
+                if (r.ptr != 0)
+                    place(r.ptr, r.size);
+            }
+            else if (r.ptr == 0)
+            {
+                // realloc(p, 0) frees p; a failed realloc keeps it
+                if (r.size == 0)
+                    release(r.old_ptr);
+            }
+            else if (found->second < 0)
+            {
+                block_of.erase(found);
+                place(r.ptr, r.size);
+            }
+            else
+            {
+                int id = found->second;
+                size_t old_requested = heap.block_by_id[id]->requested;
+                block_of.erase(found);
+                res.allocs++;
+
+                // Placement of a moving realloc is timed by place_block;
+                // an in-place resize places nothing and is not timed
+                ReallocResult moved = heap.realloc(id, r.size ? r.size : 1, type);
+
+                if (moved.ok)
+                {
+                    live_bytes += moved.block.requested;
+                    live_bytes -= old_requested;
+                    id = moved.block.id;
+                }
+                else
+                {
+                    res.failed++;
+                }
+                release(r.ptr);
+                block_of[r.ptr] = id;
+            }
+        }
+        else if (r.ptr != 0)
+        {
+            place(r.ptr, r.size);
+        }
+
+        res.peak_used = max(res.peak_used, heap.used_bytes);
+
+        if ((i + 1) % interval == 0 || i + 1 == records.size())
+        {
+            const FreeSpaceStats &fs = heap.free_stats();
+            ReplaySample s;
+            s.event = i + 1;
+            s.live_bytes = live_bytes;
+            s.used_bytes = heap.used_bytes;
+            s.largest_free = heap.largest_free();
+            s.external = external_frag(fs.free_bytes, s.largest_free);
+            res.samples.push_back(s);
+        }
+    }
+
+    res.timed = heap.strategy_stats[type].requests;
+    res.total_ns = heap.strategy_stats[type].total_ns;
+    return res;
+}
+
+/*
+ * Replays the trace on a buddy allocator over the heap size rounded
+ * up to a power of two. A realloc is modeled as allocate, copy and free.
+ */
+static ReplayResult replay_buddy(const vector<TraceRecord> &records,
+                                 size_t heap_size, size_t interval)
+{
+    ReplayResult res;
+    res.name = "buddy";
+
+    size_t size = 16;
+    while (size < heap_size)
+        size <<= 1;
+    res.memory = size;
+
+    BuddyAllocator buddy(size, 16);
+    buddy.verbose = false;
+
+    unordered_map<uint64_t, size_t> address_of;   // Traced pointer → address
+
+    auto release = [&](uint64_t ptr) -> bool {
+        auto found = address_of.find(ptr);
+        if (found == address_of.end())
+            return false;
+        if (found->second != BuddyAllocator::NONE)
+            buddy.free_block(found->second);
+        address_of.erase(found);
+        return true;
+    };
+
+    auto place = [&](size_t bytes) -> size_t {
+        res.allocs++;
+        if (bytes == 0)
+            bytes = 1;
+        auto begin = chrono::steady_clock::now();
+        size_t addr = buddy.allocate(bytes);
+        auto end = chrono::steady_clock::now();
+        res.timed++;
+        res.total_ns += chrono::duration<double, nano>(end - begin).count();
+        if (addr == BuddyAllocator::NONE)
+            res.failed++;
+        return addr;
+    };
+
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const TraceRecord &r = records[i];
+
+        if (r.op == TRACE_FREE)
+        {
+            if (!release(r.ptr))
+                res.unmatched++;
+        }
+        else if (r.op == TRACE_REALLOC && r.old_ptr != 0)
+        {
+            bool known = address_of.count(r.old_ptr) != 0;
+            if (!known)
+                res.unmatched++;
+
+            if (r.ptr == 0)
+            {
+                if (r.size == 0)
+                    release(r.old_ptr);
+            }
+            else
+            {
+                size_t addr = place(r.size);
+                if (addr == BuddyAllocator::NONE && known)
+                {
+                    // Keep the old block under the new pointer
+                    addr = address_of[r.old_ptr];
+                    address_of.erase(r.old_ptr);
+                }
+                else
+                {
+                    release(r.old_ptr);
+                }
+                release(r.ptr);
+                address_of[r.ptr] = addr;
+            }
+        }
+        else if (r.ptr != 0)
+        {
+            release(r.ptr);
+            address_of[r.ptr] = place(r.size);
+        }
+
+        res.peak_used = max(res.peak_used, buddy.allocated_bytes);
+
+        if ((i + 1) % interval == 0 || i + 1 == records.size())
+        {
+            size_t free_bytes = buddy.total_size - buddy.allocated_bytes;
+            size_t largest = buddy.largest_free();
+
+            ReplaySample s;
+            s.event = i + 1;
+            s.live_bytes = buddy.requested_bytes;
+            s.used_bytes = buddy.allocated_bytes;
+            s.largest_free = largest;
+            s.external = external_frag(free_bytes, largest);
+            res.samples.push_back(s);
+        }
+    }
+    return res;
+}
+
+/*
+ * Prints the fragmentation time series of one replay.
+ */
+static void print_samples(const ReplayResult &res)
+{
+    cout << "\n" << res.name << "\n";
+    cout << right << setw(10) << "event" << setw(14) << "live bytes"
+         << setw(14) << "used bytes" << setw(14) << "largest free"
+         << setw(11) << "int frag" << setw(11) << "ext frag" << "\n";
+
+    for (size_t k = 0; k < res.samples.size(); k++)
+    {
+        const ReplaySample &s = res.samples[k];
+        double internal = s.used_bytes
+            ? 100.0 * (s.used_bytes - s.live_bytes) / s.used_bytes : 0;
+
+        cout << setw(10) << s.event << setw(14) << s.live_bytes
+             << setw(14) << s.used_bytes << setw(14) << s.largest_free
+             << fixed << setprecision(1)
+             << setw(10) << internal << "%"
+             << setw(10) << s.external << "%\n";
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
+}
+
+/*
+ * Loads the trace, replays it through every strategy and prints the
+ * per-strategy time series followed by a summary table.
+ */
+void run_trace_replay(const string &path, size_t heap_size, int samples)
+{
+    vector<TraceRecord> records;
+    if (!load_trace(path, records))
+        return;
+    if (records.empty())
+    {
+        cout << "Trace " << path << " is empty\n";
+        return;
+    }
+
+    unordered_map<uint32_t, bool> threads;
+    for (size_t i = 0; i < records.size(); i++)
+        threads[records[i].thread] = true;
+
+    double span_ms = (records.back().time_ns - records.front().time_ns) / 1e6;
+    size_t interval = (records.size() + samples - 1) / samples;
+    if (interval == 0)
+        interval = 1;
+
+    vector<ReplayResult> results;
+    results.push_back(replay_heap(records, FIRST_FIT, heap_size, interval));
+    results.push_back(replay_heap(records, BEST_FIT, heap_size, interval));
+    results.push_back(replay_heap(records, WORST_FIT, heap_size, interval));
+    results.push_back(replay_buddy(records, heap_size, interval));
+
+    cout << "Trace " << path << ": " << records.size() << " calls from "
+         << threads.size() << " thread(s) over " << span_ms << " ms\n";
+    cout << "Replaying on a " << heap_size << "-byte heap";
+    if (results.back().memory != heap_size)
+        cout << " (buddy: " << results.back().memory << ")";
+    cout << "\n";
+
+    for (size_t k = 0; k < results.size(); k++)
+        print_samples(results[k]);
+
+    cout << "\n" << left << setw(11) << "strategy" << right
+         << setw(9) << "allocs" << setw(8) << "failed"
+         << setw(11) << "unmatched" << setw(12) << "peak used"
+         << setw(12) << "mean ext" << setw(10) << "ns/op" << "\n";
+
+    for (size_t k = 0; k < results.size(); k++)
+    {
+        const ReplayResult &res = results[k];
+        double mean_ext = 0;
+        for (size_t j = 0; j < res.samples.size(); j++)
+            mean_ext += res.samples[j].external;
+        mean_ext /= res.samples.size();
+
+        cout << left << setw(11) << res.name << right
+             << setw(9) << res.allocs << setw(8) << res.failed
+             << setw(11) << res.unmatched << setw(12) << res.peak_used
+             << fixed << setprecision(1)
+             << setw(11) << mean_ext << "%"
+             << setw(10) << (res.timed ? res.total_ns / res.timed : 0)
+             << "\n";
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
+}
@@ -0,0 +1,123 @@
+#include "tlb.h"
+
+using namespace std;
+
+/*
+ * Constructs an empty TLB.
+ *
+ * @param n  Number of entries (0 disables the TLB)
+ * @param a  Associativity (entries per set)
+ * @param p  Replacement policy
+ */
+TLB::TLB(int n, int a, TlbPolicy p)
+    : entries(n), associativity(a), policy(p)
+{
+    sets_count = (n > 0 && a > 0) ? n / a : 0;
+    sets.assign(sets_count, vector<TlbEntry>(associativity));
+    flush();
+}
+
+/*
+ * Looks up a page in its set.
+ */
+bool TLB::lookup(size_t page, int &frame)
+{
+    if (!enabled())
+        return false;
+
+    for (auto &entry : sets[page % sets_count])
+    {
+        if (entry.valid && entry.page == page)
+        {
+            hits++;
+            entry.last_used = ++tick;
+            frame = entry.frame;
+            return true;
+        }
+    }
+
+    misses++;
+    return false;
+}
+
+/*
+ * Fills a translation, preferring an invalid entry of the set.
+ */
+void TLB::insert(size_t page, int frame)
+{
+    if (!enabled())
+        return;
+
+    auto &set = sets[page % sets_count];
+    TlbEntry *victim = nullptr;
+
+    for (auto &entry : set)
+    {
+        // Already cached: refresh the entry in place
+        if (entry.valid && entry.page == page)
+        {
+            victim = &entry;
+            break;
+        }
+        if (!entry.valid && !victim)
+            victim = &entry;
+    }
+
+    if (!victim)
+    {
+        if (policy == TLB_RANDOM)
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            victim = &set[seed % set.size()];
+        }
+        else
+        {
+            victim = &set[0];
+            for (auto &entry : set)
+                if (entry.last_used < victim->last_used)
+                    victim = &entry;
+        }
+    }
+
+    victim->valid = true;
+    victim->page = page;
+    victim->frame = frame;
+    victim->last_used = ++tick;
+}
+
+/*
+ * Invalidates the entry of a page, if cached.
+ */
+bool TLB::invalidate(size_t page)
+{
+    if (!enabled())
+        return false;
+
+    for (auto &entry : sets[page % sets_count])
+    {
+        if (entry.valid && entry.page == page)
+        {
+            entry.valid = false;
+            invalidations++;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Invalidates every entry.
+ */
+void TLB::flush()
+{
+    for (auto &set : sets)
+        for (auto &entry : set)
+        {
+            entry.valid = false;
+            entry.page = 0;
+            entry.frame = -1;
+            entry.last_used = 0;
+        }
+}
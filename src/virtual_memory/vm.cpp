@@ -1,8 +1,12 @@
 #include "vm.h"
 #include <iostream>
+#include <unordered_map>
 
 using namespace std;
 
+const size_t VirtualMemory::NO_PAGE;
+const size_t VirtualMemory::NEVER;
+
 /*
  * Constructs a virtual memory subsystem.
  *
@@ -13,124 +17,540 @@ using namespace std;
  * Initializes page tables, frame mappings, and replacement metadata.
  */
 VirtualMemory::VirtualMemory(int frames, int ps, PageReplacement p)
-    : num_frames(frames), page_size(ps), policy(p), clock_hand(0)
+    : page_size(ps), num_frames(frames), policy(p), clock_hand(0)
 {
-    // Fixed-size virtual address space: 256 virtual pages
-    page_table.resize(256);
+    // Disk access counter used to simulate page fault cost
+    disk_accesses = 0;
 
-    // Frame-to-page reverse mapping (-1 indicates free frame)
-    frame_to_page.resize(frames, -1);
+    // 16-bit address space (256 pages of 256 bytes), 2-level table
+    set_address_space(va_bits, levels);
+}
 
-    // Disk access counter used to simulate page fault cost
+/*
+ * Rebuilds the address space: splits the page number bits across
+ * the levels, allocates an empty root table and releases every frame.
+ */
+bool VirtualMemory::set_address_space(int bits, int depth)
+{
+    int page_bits = 0;
+    while (((size_t)2 << page_bits) <= (size_t)page_size)
+        page_bits++;
+
+    int vpn_bits = bits - page_bits;
+    if (bits > 48 || depth < 1 || depth > 5 || vpn_bits < depth)
+        return false;
+
+    va_bits = bits;
+    levels = depth;
+
+    // Even split, the root takes the remainder
+    level_bits.assign(levels, vpn_bits / levels);
+    level_bits[0] += vpn_bits % levels;
+
+    level_shift.assign(levels, 0);
+    for (int l = levels - 2; l >= 0; l--)
+        level_shift[l] = level_shift[l + 1] + level_bits[l + 1];
+
+    tables.clear();
+    new_table(0);
+
+    // Frame-to-page reverse mapping (NO_PAGE indicates free frame)
+    frame_to_page.assign(num_frames, NO_PAGE);
+    clock_hand = 0;
+
+    // Every frame free, handed out in ascending order
+    free_frames.clear();
+    for (int i = num_frames - 1; i >= 0; i--)
+        free_frames.push_back(i);
+    fifo_queue.clear();
+
+    // Replacement state starts empty
+    frame_state.assign(num_frames, FrameState());
+    lru_head = lru_tail = -1;
+    by_next_use.clear();
+
+    tlb = TLB(tlb.entries, tlb.associativity, tlb.policy);
+    stlb = TLB(stlb.entries, stlb.associativity, stlb.policy);
+
+    fifo_tick = 0;
+    vtime = 0;
+    page_faults = 0;
+    page_hits = 0;
+    reads = 0;
+    writes = 0;
     disk_accesses = 0;
+    page_ins = 0;
+    page_outs = 0;
+    reset_translation_stats();
+    return true;
+}
+
+/*
+ * Appends an empty table for `level` and returns its index.
+ * Leaf tables hold invalid entries, interior tables no children.
+ */
+int VirtualMemory::new_table(int level)
+{
+    size_t size = (size_t)1 << level_bits[level];
+
+    tables.push_back(PageTableNode());
+    PageTableNode &table = tables.back();
+    if (level == levels - 1)
+        table.entries.assign(size, PageTableEntry{false, -1, 0, false, false});
+    else
+        table.child.assign(size, -1);
+
+    return (int)tables.size() - 1;
+}
 
-    // Initialize page table entries
-    for (auto &pte : page_table)
+/*
+ * Walks the radix table for `page`, counting the tables read in
+ * `read`. Returns nullptr when an intermediate table is missing,
+ * i.e. the page has never been mapped.
+ */
+PageTableEntry *VirtualMemory::find_pte(size_t page, int &read)
+{
+    int node = 0;
+    read = 0;
+
+    for (int l = 0; l < levels - 1; l++)
     {
-        pte.valid = false;
-        pte.frame = -1;
-        pte.fifo_order = 0;
-        pte.reference = false;
+        read++;
+        size_t index = (page >> level_shift[l]) &
+                       (((size_t)1 << level_bits[l]) - 1);
+        node = tables[node].child[index];
+        if (node < 0)
+            return nullptr;
+    }
+
+    read++;
+    size_t index = page & (((size_t)1 << level_bits[levels - 1]) - 1);
+    return &tables[node].entries[index];
+}
+
+/*
+ * Returns the entry for `page`, allocating missing tables on the way.
+ */
+PageTableEntry &VirtualMemory::map_pte(size_t page)
+{
+    int node = 0;
+
+    for (int l = 0; l < levels - 1; l++)
+    {
+        size_t index = (page >> level_shift[l]) &
+                       (((size_t)1 << level_bits[l]) - 1);
+        if (tables[node].child[index] < 0)
+        {
+            int table = new_table(l + 1);
+            tables[node].child[index] = table;
+        }
+        node = tables[node].child[index];
     }
+
+    size_t index = page & (((size_t)1 << level_bits[levels - 1]) - 1);
+    return tables[node].entries[index];
 }
 
 /*
  * Translates a virtual address to a physical address.
  *
  * Translation flow:
- * Virtual Address → Page Number + Offset → Page Table → Physical Frame
+ * Virtual Address → Page Number + Offset → TLBs → Radix Page Table
+ *                 → Physical Frame
  *
  * Handles:
  * - Page hits
  * - Page faults
  * - Page replacement (FIFO or Clock)
  */
-size_t VirtualMemory::translate(size_t virtual_address)
+size_t VirtualMemory::translate(size_t virtual_address, AccessType type)
 {
     size_t page = virtual_address / page_size;
     size_t offset = virtual_address % page_size;
 
     // Validate virtual page number
-    if (page >= page_table.size())
+    if (virtual_address >= get_virtual_memory_size())
     {
         cout << "Segmentation fault: invalid page access\n";
         return 0;
     }
 
+    // Position of this reference; NFU and aging sample the
+    // reference bits every aging_interval references
+    size_t now = vtime++;
+    if (type == WRITE_ACCESS)
+        writes++;
+    else
+        reads++;
+    if ((policy == NFU_REPL || policy == AGING_REPL) && now > 0 &&
+        now % aging_interval == 0)
+        age_counters();
+
+    // TLB hit: the translation is cached, no page table access
+    int cached;
+    translations++;
+    if (tlb.enabled())
+        translation_cycles += tlb_latency;
+    if (tlb.lookup(page, cached))
+    {
+        page_hits++;
+        touch(page, cached, now, type);
+        return cached * page_size + offset;
+    }
+
+    // Second-level TLB, refilling the first level on a hit
+    if (stlb.enabled())
+    {
+        translation_cycles += stlb_latency;
+        miss_cycles += stlb_latency;
+        if (stlb.lookup(page, cached))
+        {
+            page_hits++;
+            touch(page, cached, now, type);
+            tlb.insert(page, cached);
+            return cached * page_size + offset;
+        }
+    }
+
+    // Page walk, one table read per level until the leaf or a
+    // missing table
+    int read;
+    PageTableEntry *pte = find_pte(page, read);
+    page_walks++;
+    walk_levels += read;
+    translation_cycles += read * level_latency;
+    miss_cycles += read * level_latency;
+
     // Page hit: page already mapped to a physical frame
-    if (page_table[page].valid)
+    if (pte && pte->valid)
     {
         page_hits++;
-        page_table[page].reference = true;
-        return page_table[page].frame * page_size + offset;
+        touch(page, pte->frame, now, type);
+        tlb.insert(page, pte->frame);
+        stlb.insert(page, pte->frame);
+        return pte->frame * page_size + offset;
     }
 
-    // PAGE FAULT
+    // PAGE FAULT: the page is read in from disk
     page_faults++;
+    page_ins++;
     disk_accesses++;
     fifo_tick++;
 
     int frame = -1;
 
-    // Attempt to find a free physical frame
-    for (int i = 0; i < num_frames; i++)
+    // Take a free physical frame if any is left
+    if (!free_frames.empty())
+    {
+        frame = free_frames.back();
+        free_frames.pop_back();
+    }
+
+    // Every frame is in use: evict the page the policy selects
+    if (frame == -1)
+    {
+        frame = choose_victim(now);
+
+        size_t victim_page = frame_to_page[frame];
+        PageTableEntry &victim = map_pte(victim_page);
+        if (victim.dirty)
+            write_back(victim);
+        victim.valid = false;
+        shootdown(victim_page);
+
+        lru_unlink(frame);
+        by_next_use.erase(make_pair(frame_state[frame].next_use, frame));
+    }
+
+    // Map the new page into the selected frame, allocating any
+    // missing tables on the way
+    PageTableEntry &entry = map_pte(page);
+    entry.valid = true;
+    entry.frame = frame;
+    entry.fifo_order = fifo_tick;
+    entry.dirty = false;
+    frame_to_page[frame] = page;
+    if (policy == FIFO_REPL)
+        fifo_queue.push_back(page);
+
+    frame_state[frame].counter = 0;
+    frame_state[frame].last_use = now;
+    touch(page, frame, now, type);
+    tlb.insert(page, frame);
+    stlb.insert(page, frame);
+
+    return frame * page_size + offset;
+}
+
+/*
+ * Records a reference to the resident `page` in `frame`: sets its
+ * reference bit (and dirty bit on a write) and updates the LRU order
+ * or OPT next use.
+ */
+void VirtualMemory::touch(size_t page, int frame, size_t now,
+                          AccessType type)
+{
+    PageTableEntry &pte = map_pte(page);
+    pte.reference = true;
+    if (type == WRITE_ACCESS)
+        pte.dirty = true;
+
+    if (policy == LRU_REPL)
+    {
+        lru_unlink(frame);
+        lru_push_front(frame);
+    }
+    else if (policy == OPT_REPL)
+    {
+        FrameState &state = frame_state[frame];
+        by_next_use.erase(make_pair(state.next_use, frame));
+        state.next_use = now < next_reference.size() ? next_reference[now]
+                                                     : NEVER;
+        by_next_use.insert(make_pair(state.next_use, frame));
+    }
+}
+
+/*
+ * Selects the frame to evict when every frame is in use.
+ */
+int VirtualMemory::choose_victim(size_t now)
+{
+    switch (policy)
+    {
+    case FIFO_REPL:
     {
-        if (frame_to_page[i] == -1)
+        // The page loaded first is at the head of the queue
+        size_t victim_page = fifo_queue.front();
+        fifo_queue.pop_front();
+        return map_pte(victim_page).frame;
+    }
+
+    case LRU_REPL:
+        return lru_tail;
+
+    case NFU_REPL:
+    case AGING_REPL:
+    {
+        // Smallest counter; on a tie, prefer pages not referenced
+        // since the last sample
+        int victim = 0;
+        uint64_t lowest = UINT64_MAX;
+        for (int f = 0; f < num_frames; f++)
         {
-            frame = i;
-            break;
+            uint64_t key = ((uint64_t)frame_state[f].counter << 1) |
+                           map_pte(frame_to_page[f]).reference;
+            if (key < lowest)
+            {
+                lowest = key;
+                victim = f;
+            }
         }
+        return victim;
     }
 
-    // Clock (Second-Chance) replacement policy
-    if (frame == -1 && policy == CLOCK_REPL)
+    case WSCLOCK_REPL:
     {
-        while (true)
+        // One sweep: referenced pages are stamped with the current
+        // time, the first page older than the window is evicted.
+        // Failing that, the least recently stamped page goes.
+        int oldest = clock_hand;
+        for (int step = 0; step < num_frames; step++)
         {
-            int victim_page = frame_to_page[clock_hand];
+            int f = clock_hand;
+            clock_hand = (clock_hand + 1) % num_frames;
 
-            // Select page with reference bit cleared
-            if (!page_table[victim_page].reference)
+            PageTableEntry &pte = map_pte(frame_to_page[f]);
+            FrameState &state = frame_state[f];
+            if (pte.reference)
+            {
+                pte.reference = false;
+                state.last_use = now;
+            }
+            else if (now - state.last_use > (size_t)ws_window)
             {
-                frame = clock_hand;
-                page_table[victim_page].valid = false;
-                break;
+                // A dirty page outside the window is cleaned and
+                // passed over, clean ones are evicted
+                if (!pte.dirty)
+                    return f;
+                write_back(pte);
             }
 
-            // Clear reference bit and advance clock hand
-            page_table[victim_page].reference = false;
-            clock_hand = (clock_hand + 1) % num_frames;
+            if (state.last_use < frame_state[oldest].last_use)
+                oldest = f;
         }
+        return oldest;
     }
 
-    // FIFO page replacement policy
-    if (frame == -1 && policy == FIFO_REPL)
-    {
-        int victim_page = -1;
-        int oldest = 1e9;
+    case OPT_REPL:
+        // The page whose next use lies furthest in the future
+        return by_next_use.rbegin()->second;
 
-        // Select the page with the oldest insertion timestamp
-        for (int i = 0; i < 256; i++)
+    default:
+        // Clock as enhanced second chance, evicting in NRU class
+        // order (reference, dirty): (0,0), then (0,1), then the
+        // pages that were referenced. Pass 1 looks for (0,0) leaving
+        // the bits alone; pass 2 looks for (0,1), clearing reference
+        // bits on the way. After pass 2 every bit is clear, so the
+        // next pass 1 or pass 2 finds a victim.
+        while (true)
         {
-            if (page_table[i].valid && page_table[i].fifo_order < oldest)
+            for (int step = 0; step < num_frames; step++)
             {
-                oldest = page_table[i].fifo_order;
-                victim_page = i;
+                PageTableEntry &pte = map_pte(frame_to_page[clock_hand]);
+                if (!pte.reference && !pte.dirty)
+                    return clock_hand;
+                clock_hand = (clock_hand + 1) % num_frames;
+            }
+
+            for (int step = 0; step < num_frames; step++)
+            {
+                PageTableEntry &pte = map_pte(frame_to_page[clock_hand]);
+                if (!pte.reference && pte.dirty)
+                    return clock_hand;
+                pte.reference = false;
+                clock_hand = (clock_hand + 1) % num_frames;
             }
         }
+    }
+}
+
+/*
+ * Writes a dirty page back to disk; it stays resident and clean.
+ */
+void VirtualMemory::write_back(PageTableEntry &pte)
+{
+    pte.dirty = false;
+    page_outs++;
+    disk_accesses++;
+}
+
+/*
+ * NFU adds each resident page's reference bit to its counter; aging
+ * shifts the counter right and inserts the bit at the top. Reference
+ * bits are cleared for the next interval.
+ */
+void VirtualMemory::age_counters()
+{
+    for (int f = 0; f < num_frames; f++)
+    {
+        if (frame_to_page[f] == NO_PAGE)
+            continue;
 
-        frame = page_table[victim_page].frame;
-        page_table[victim_page].valid = false;
+        PageTableEntry &pte = map_pte(frame_to_page[f]);
+        uint32_t &counter = frame_state[f].counter;
+        if (policy == NFU_REPL)
+            counter += pte.reference;
+        else
+            counter = (counter >> 1) | (pte.reference ? 0x80000000u : 0);
+        pte.reference = false;
     }
+}
 
-    // Map the new page into the selected frame
-    page_table[page].valid = true;
-    page_table[page].frame = frame;
-    page_table[page].fifo_order = fifo_tick;
-    page_table[page].reference = true;
-    frame_to_page[frame] = page;
+/*
+ * Removes a frame from the LRU list (no-op if it is not linked).
+ */
+void VirtualMemory::lru_unlink(int frame)
+{
+    FrameState &state = frame_state[frame];
+    if (state.lru_prev == -1 && lru_head != frame)
+        return;
 
-    return frame * page_size + offset;
+    if (state.lru_prev != -1)
+        frame_state[state.lru_prev].lru_next = state.lru_next;
+    else
+        lru_head = state.lru_next;
+
+    if (state.lru_next != -1)
+        frame_state[state.lru_next].lru_prev = state.lru_prev;
+    else
+        lru_tail = state.lru_prev;
+
+    state.lru_prev = state.lru_next = -1;
+}
+
+/*
+ * Links a frame at the most recently used end of the LRU list.
+ */
+void VirtualMemory::lru_push_front(int frame)
+{
+    FrameState &state = frame_state[frame];
+    state.lru_prev = -1;
+    state.lru_next = lru_head;
+    if (lru_head != -1)
+        frame_state[lru_head].lru_prev = frame;
+    else
+        lru_tail = frame;
+    lru_head = frame;
+}
+
+/*
+ * Switches policy and starts over with an empty address space.
+ */
+void VirtualMemory::set_policy(PageReplacement p)
+{
+    policy = p;
+    set_address_space(va_bits, levels);
+}
+
+/*
+ * Precomputes, for every position of the reference string, where the
+ * same page is referenced next, scanning backwards.
+ */
+void VirtualMemory::set_future(const vector<size_t> &addresses)
+{
+    next_reference.assign(addresses.size(), NEVER);
+
+    unordered_map<size_t, size_t> seen;   // page → later position
+    for (size_t i = addresses.size(); i-- > 0; )
+    {
+        size_t page = addresses[i] / page_size;
+        auto found = seen.find(page);
+        if (found != seen.end())
+            next_reference[i] = found->second;
+        seen[page] = i;
+    }
+}
+
+/*
+ * Invalidates an evicted page's translation in every TLB, as the
+ * OS must before the frame is reused.
+ */
+void VirtualMemory::shootdown(size_t page)
+{
+    bool cached = tlb.invalidate(page);
+    cached = stlb.invalidate(page) || cached;
+    if (cached)
+        shootdowns++;
+}
+
+/*
+ * Installs empty TLBs with a new geometry.
+ */
+void VirtualMemory::configure_tlb(int entries, int associativity,
+                                  TlbPolicy p)
+{
+    tlb = TLB(entries, associativity, p);
+    reset_translation_stats();
+}
+
+void VirtualMemory::configure_stlb(int entries, int associativity)
+{
+    stlb = TLB(entries, associativity, TLB_LRU);
+    reset_translation_stats();
+}
+
+/*
+ * Starts the translation counters over so they describe the new
+ * TLB geometry. Page hit / fault counters are kept.
+ */
+void VirtualMemory::reset_translation_stats()
+{
+    translations = 0;
+    page_walks = 0;
+    walk_levels = 0;
+    shootdowns = 0;
+    translation_cycles = 0;
+    miss_cycles = 0;
 }
 
 /*
@@ -138,7 +558,7 @@ size_t VirtualMemory::translate(size_t virtual_address)
  */
 size_t VirtualMemory::get_virtual_memory_size() const
 {
-    return page_table.size() * page_size;
+    return (size_t)1 << va_bits;
 }
 
 /*
@@ -158,8 +578,77 @@ void VirtualMemory::stats()
     cout << "\n--- Virtual Memory Stats ---\n";
     cout << "Page hits: " << page_hits << endl;
     cout << "Page faults: " << page_faults << endl;
-    cout << "Disk accesses: " << disk_accesses << endl;
+    cout << "Disk accesses: " << disk_accesses << " (page-ins: "
+         << page_ins << ", page-outs: " << page_outs << ")" << endl;
+    cout << "Reads: " << reads << " Writes: " << writes << endl;
     cout << "Simulated disk latency per fault: "
          << DISK_LATENCY << " cycles" << endl;
     cout << "Page fault rate: " << fault_rate() << endl;
+    cout << "Replacement policy: " << replacement_name(policy) << endl;
+
+    cout << "TLB: " << tlb.entries << " entries, " << tlb.associativity
+         << "-way, " << (tlb.policy == TLB_LRU ? "LRU" : "random")
+         << " | Hits: " << tlb.hits << " Misses: " << tlb.misses
+         << " Hit Ratio: " << tlb.hit_ratio() << endl;
+
+    if (stlb.enabled())
+        cout << "STLB: " << stlb.entries << " entries, "
+             << stlb.associativity << "-way"
+             << " | Hits: " << stlb.hits << " Misses: " << stlb.misses
+             << " Hit Ratio: " << stlb.hit_ratio() << endl;
+
+    cout << "Page walks: " << page_walks << endl;
+    cout << "TLB shootdowns: " << shootdowns << endl;
+    cout << "Translation cycles: " << translation_cycles
+         << " (avg TLB miss penalty: "
+         << (translations > tlb.hits
+             ? (double)miss_cycles / (translations - tlb.hits) : 0)
+         << " cycles)" << endl;
+
+    // Page table geometry and footprint (8-byte entries)
+    size_t table_bytes = 0;
+    for (const auto &table : tables)
+        table_bytes += (table.child.size() + table.entries.size()) * 8;
+
+    cout << "Address space: " << va_bits << "-bit, " << levels
+         << "-level page table (index bits";
+    for (int l = 0; l < levels; l++)
+        cout << (l ? "+" : " ") << level_bits[l];
+    cout << ")" << endl;
+    cout << "Page tables: " << tables.size() << " (" << table_bytes
+         << " bytes, a flat table would need "
+         << (get_virtual_memory_size() / page_size) * 8 << ")" << endl;
+    cout << "Average walk depth: "
+         << (page_walks ? (double)walk_levels / page_walks : 0)
+         << " levels" << endl;
+}
+
+/*
+ * Returns the CLI name of a page replacement policy.
+ */
+const char *replacement_name(PageReplacement policy)
+{
+    switch (policy)
+    {
+    case FIFO_REPL:    return "fifo";
+    case CLOCK_REPL:   return "clock";
+    case LRU_REPL:     return "lru";
+    case NFU_REPL:     return "nfu";
+    case AGING_REPL:   return "aging";
+    case WSCLOCK_REPL: return "wsclock";
+    default:           return "opt";
+    }
+}
+
+bool parse_replacement(const string &name, PageReplacement &policy)
+{
+    for (int p = 0; p < REPLACEMENT_POLICIES; p++)
+    {
+        if (name == replacement_name((PageReplacement)p))
+        {
+            policy = (PageReplacement)p;
+            return true;
+        }
+    }
+    return false;
 }
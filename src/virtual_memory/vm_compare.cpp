@@ -0,0 +1,128 @@
+#include "vm.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+/*
+ * Collects the reference string of a CLI script: the address and
+ * access type of every `access` line, in order. A `set vm <bits>
+ * <levels>` line changes the address space the references are
+ * checked against; out-of-range addresses and unknown access types
+ * are skipped, as the CLI rejects them.
+ */
+static bool load_accesses(const string &path, vector<size_t> &addresses,
+                          vector<AccessType> &types, int &va_bits, int &levels)
+{
+    ifstream in(path.c_str());
+    if (!in)
+    {
+        cout << "Cannot open " << path << "\n";
+        return false;
+    }
+
+    string line;
+    while (getline(in, line))
+    {
+        istringstream words(line);
+        string command;
+        words >> command;
+
+        size_t addr;
+        if (command == "access" && words >> hex >> addr)
+        {
+            string mode;
+            words >> mode;
+            bool valid_mode = mode == "" || mode == "r" || mode == "w";
+            if (valid_mode && (va_bits >= 64 || addr < ((size_t)1 << va_bits)))
+            {
+                addresses.push_back(addr);
+                types.push_back(mode == "w" ? WRITE_ACCESS : READ_ACCESS);
+            }
+        }
+        else if (command == "set")
+        {
+            string target;
+            int bits, depth;
+            if (words >> target >> bits >> depth && target == "vm")
+            {
+                va_bits = bits;
+                levels = depth;
+            }
+        }
+        else if (command == "exit")
+        {
+            break;
+        }
+    }
+    return true;
+}
+
+/*
+ * Replays the reference string of `path` through every replacement
+ * policy with `frames` frames (the geometry of `like` by default)
+ * and reports faults against the OPT lower bound.
+ */
+void run_vm_compare(const string &path, int frames, const VirtualMemory &like)
+{
+    int va_bits = like.va_bits;
+    int levels = like.levels;
+    vector<size_t> addresses;
+    vector<AccessType> types;
+    if (!load_accesses(path, addresses, types, va_bits, levels))
+        return;
+
+    if (addresses.empty())
+    {
+        cout << "No valid access lines in " << path << "\n";
+        return;
+    }
+    if (frames <= 0)
+        frames = like.num_frames;
+
+    vector<int> faults(REPLACEMENT_POLICIES), page_outs(REPLACEMENT_POLICIES);
+    for (int p = 0; p < REPLACEMENT_POLICIES; p++)
+    {
+        VirtualMemory vm(frames, like.page_size, (PageReplacement)p);
+        vm.aging_interval = like.aging_interval;
+        vm.ws_window = like.ws_window;
+        if (!vm.set_address_space(va_bits, levels))
+        {
+            cout << "Unsupported address space: " << va_bits << " bits, "
+                 << levels << " levels\n";
+            return;
+        }
+        if (p == OPT_REPL)
+            vm.set_future(addresses);
+
+        for (size_t i = 0; i < addresses.size(); i++)
+            vm.translate(addresses[i], types[i]);
+        faults[p] = vm.page_faults;
+        page_outs[p] = vm.page_outs;
+    }
+
+    int best = faults[OPT_REPL];
+    cout << "VM compare " << path << ": " << addresses.size()
+         << " references, " << frames << " frames of "
+         << like.page_size << " bytes\n";
+    cout << left << setw(10) << "policy" << right
+         << setw(9) << "faults" << setw(12) << "fault rate"
+         << setw(18) << "over OPT" << setw(11) << "page-outs" << "\n";
+
+    for (int p = 0; p < REPLACEMENT_POLICIES; p++)
+    {
+        ostringstream over;
+        over << fixed << setprecision(1) << "+" << faults[p] - best << " ("
+             << (best ? 100.0 * (faults[p] - best) / best : 0) << "%)";
+
+        cout << left << setw(10) << replacement_name((PageReplacement)p)
+             << right << setw(9) << faults[p]
+             << fixed << setprecision(1)
+             << setw(11) << 100.0 * faults[p] / addresses.size() << "%"
+             << setw(18) << over.str() << setw(11) << page_outs[p] << "\n";
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
+}